@@ -2,111 +2,257 @@
  * \file   cross.cpp
  * \brief  checks for intersection between start and end point of lines/tubes
  * 
+ * a bounding volume hierarchy over the boxes of the tubes delivers the candidate pairs,
+ * only these are checked exactly (distance of the straight lines and position on both tubes)
+ * 
  * \author rainer_jordan-at-<very, very warm>mail.com
 * #### Licence
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
   *********************************************************************/
 #include "common.h"
+#include <algorithm>
+#include <numeric>
 
 extern size_t mTb; // max index of tubes (max number of tubes - 1)
 extern size_t mPt; // max index of Points (number of points - 1)  
 
 using namespace std;
 
+/// tolerance added to the boxes of the tubes [mm], larger than the distance accepted as intersection
+static const double BoxMargin = 1e-2;
+/// max number of tubes in one leaf of the hierarchy
+static const size_t LeafSize = 4;
+
+/*!
+* \class _box
+* \brief axis aligned bounding box of a tube
+*/
+class _box {
+public:
+   double Min[3]; ///< lower x, y, z [mm]
+   double Max[3]; ///< upper x, y, z [mm]
+
+   void set(const _point& a, const _point& b) {
+      Min[0] = fmin(a.xCoord, b.xCoord) - BoxMargin;
+      Min[1] = fmin(a.yCoord, b.yCoord) - BoxMargin;
+      Min[2] = fmin(a.zCoord, b.zCoord) - BoxMargin;
+      Max[0] = fmax(a.xCoord, b.xCoord) + BoxMargin;
+      Max[1] = fmax(a.yCoord, b.yCoord) + BoxMargin;
+      Max[2] = fmax(a.zCoord, b.zCoord) + BoxMargin;
+   }
+   void merge(const _box& b) {
+      for (int k = 0; k < 3; k++) {
+         Min[k] = fmin(Min[k], b.Min[k]);
+         Max[k] = fmax(Max[k], b.Max[k]);
+      }
+   }
+   bool overlaps(const _box& b) const {
+      return Min[0] <= b.Max[0] && b.Min[0] <= Max[0] &&
+         Min[1] <= b.Max[1] && b.Min[1] <= Max[1] &&
+         Min[2] <= b.Max[2] && b.Min[2] <= Max[2];
+   }
+   double center(int k) const { return Min[k] + Max[k]; }
+};
+
+/*!
+* \class _bvh
+* \brief bounding volume hierarchy of the tube boxes
+*
+* the tubes are split at the median of the longest axis of the node box until a node contains LeafSize tubes or less\n
+* a leaf contains the tubes Order[First] ... Order[Last - 1]
+*/
+class _bvh {
+public:
+   struct Node {
+      _box Box;
+      size_t First, Last; ///< range in Order for leafs
+      size_t Left, Right; ///< children, MINUS1 for leafs
+   };
+   vector<Node> Nodes;
+   vector<size_t> Order;
+
+   void build(const vector<_box>& Boxes) {
+      Nodes.clear();
+      Order.resize(Boxes.size());
+      iota(Order.begin(), Order.end(), 0);
+      if (Boxes.empty()) return;
+      Nodes.reserve(2 * Boxes.size() / LeafSize + 1);
+      split(Boxes, 0, Boxes.size());
+   }
+
+   /// appends the numbers of all tubes whose box overlaps Box to Found
+   void query(const vector<_box>& Boxes, const _box& Box, vector<size_t>& Found) const {
+      if (Nodes.empty()) return;
+      size_t Stack[64];
+      size_t NoStack = 0;
+      Stack[NoStack++] = 0;
+      while (NoStack > 0) {
+         const Node& Nd = Nodes[Stack[--NoStack]];
+         if (!Nd.Box.overlaps(Box)) continue;
+         if (Nd.Left == MINUS1) {
+            for (size_t k = Nd.First; k < Nd.Last; k++) {
+               if (Boxes[Order[k]].overlaps(Box)) Found.push_back(Order[k]);
+            }
+         }
+         else {
+            Stack[NoStack++] = Nd.Right;
+            Stack[NoStack++] = Nd.Left;
+         }
+      }
+   }
+
+private:
+   size_t split(const vector<_box>& Boxes, size_t First, size_t Last) {
+      size_t iNode = Nodes.size();
+      Nodes.push_back({ Boxes[Order[First]], First, Last, MINUS1, MINUS1 });
+      for (size_t k = First + 1; k < Last; k++) {
+         Nodes[iNode].Box.merge(Boxes[Order[k]]);
+      }
+      if (Last - First <= LeafSize) return iNode;
+      const _box& Box = Nodes[iNode].Box;
+      int Axis = 0;
+      for (int k = 1; k < 3; k++) {
+         if (Box.Max[k] - Box.Min[k] > Box.Max[Axis] - Box.Min[Axis]) Axis = k;
+      }
+      size_t Mid = First + (Last - First) / 2;
+      nth_element(Order.begin() + First, Order.begin() + Mid, Order.begin() + Last,
+         [&Boxes, Axis](size_t a, size_t b) {
+            double ca = Boxes[a].center(Axis);
+            double cb = Boxes[b].center(Axis);
+            return ca < cb || (ca == cb && a < b);
+         });
+      size_t Left = split(Boxes, First, Mid);
+      size_t Right = split(Boxes, Mid, Last);
+      Nodes[iNode].Left = Left;
+      Nodes[iNode].Right = Right;
+      return iNode;
+   }
+};
+
+/**
+ * \brief exact check of two tubes
+ * \param Ti first tube
+ * \param Tj second tube
+ * \param Points vector of all point(s)
+ * \param Intersection intersection point, if found
+ * \return true if the tubes intersect beside start or end points
+ */
+static bool intersect_tubes(const _tube& Ti, const _tube& Tj, const vector <_point>& Points, _point& Intersection) {
+   double t, u;
+   if (Ti.PointIn == Tj.PointIn ||
+      Ti.PointOut == Tj.PointIn ||
+      Ti.PointIn == Tj.PointOut ||
+      Ti.PointOut == Tj.PointOut) {
+      return false;
+   }
+   double x1 = Points[Ti.PointIn].xCoord;
+   double x2 = Points[Ti.PointOut].xCoord;
+   double x3 = Points[Tj.PointIn].xCoord;
+   double x4 = Points[Tj.PointOut].xCoord;
+   double y1 = Points[Ti.PointIn].yCoord;
+   double y2 = Points[Ti.PointOut].yCoord;
+   double y3 = Points[Tj.PointIn].yCoord;
+   double y4 = Points[Tj.PointOut].yCoord;
+   double z1 = Points[Ti.PointIn].zCoord;
+   double z2 = Points[Ti.PointOut].zCoord;
+   double z3 = Points[Tj.PointIn].zCoord;
+   double z4 = Points[Tj.PointOut].zCoord;
+
+   double diff21x = x2 - x1;
+   double diff21y = y2 - y1;
+   double diff21z = z2 - z1;
+
+   double diff43x = x4 - x3;
+   double diff43y = y4 - y3;
+   double diff43z = z4 - z3;
+
+   double diff31x = x3 - x1;
+   double diff31y = y3 - y1;
+   double diff31z = z3 - z1;
+
+   double cx = diff21y * diff43z - diff21z * diff43y;
+   double cy = diff21z * diff43x - diff21x * diff43z;
+   double cz = diff21x * diff43y - diff21y * diff43x;
+   /// distance between 2 tubes is a fraction expression. It can only be 0 if numerator is 0 and denominator is not 0
+   double numerator = diff31x * cx + diff31y * cy + diff31z * cz;
+   double denominator = sqrt(cx * cx + cy * cy + cz * cz);
+   if (fabs(denominator) < 1e-9) {
+      return false;
+   }
+   double dist = numerator / denominator;
+   if (fabs(dist) >= 1e-3) { /// distance between straight lines is not 0 -> no intersection
+      return false;
+   }
+   bool isCx = (fabs(cx) > fabs(cy) && fabs(cx) > fabs(cz));
+   bool isCy = (fabs(cy) > fabs(cx) && fabs(cy) > fabs(cz));
+   bool isCz = (fabs(cz) > fabs(cx) && fabs(cz) > fabs(cy));
+   if (isCy) {
+      t = (diff31x * diff43z - diff43x * diff31z) / -cy;
+      u = (diff31x * diff21z - diff21x * diff31z) / -cy;
+   }
+   else if (isCx) {
+      t = (diff31z * diff43y - diff43z * diff31y) / -cx;
+      u = (diff31z * diff21y - diff21z * diff31y) / -cx;
+   }
+   else if (isCz) {
+      t = (diff31x * diff43y - diff43x * diff31y) / cz;
+      u = (diff31x * diff21y - diff21x * diff31y) / cz;
+   }
+   else {
+      return false;
+   }
+   if (t >= 0. && t <= 1. && u >= 0. && u <= 1.) {
+      Intersection.xCoord = x1 + t * diff21x;
+      Intersection.yCoord = y1 + t * diff21y;
+      Intersection.zCoord = z1 + t * diff21z;
+      return true;
+   }
+   return false;
+}
+
 /**
  * \fn check_intersection(vector <_tube>& Tubes, vector <_point>& Points, vector<_point>& Intersect )
+ * \brief checks all pairs of tubes for intersection
+ *
+ * only pairs with overlapping boxes (found via the bounding volume hierarchy) are checked exactly\n
+ * the tubes are checked in parallel, the intersections are collected per tube and appended in order of the tubes,
+ * thus Intersect has the same order as with checking all pairs i < j one after the other
  * \param Tubes vector of all tube(s)
  * \param Points vector of all point(s)
  * \param Intersect vector of intersection points, for error indication in dxf file
  * \return 
  */
 int check_intersection(vector <_tube>& Tubes, vector <_point>& Points, vector<_point>& Intersect ) {
-   _point Intersection;
-   double t,u;
-
-//   size_t maxTubes = Tubes.size();
-   for (size_t i = 0; i <=  mTb - 1; i++) {
-      for (size_t j = i + 1; j <= mTb; j++) {
-         if (Tubes[i].PointIn == Tubes[j].PointIn ||
-            Tubes[i].PointOut == Tubes[j].PointIn ||
-            Tubes[i].PointIn == Tubes[j].PointOut ||
-            Tubes[i].PointOut == Tubes[j].PointOut) {
-            continue;
-         }
-         double x1 = Points[Tubes[i].PointIn].xCoord;
-         double x2 = Points[Tubes[i].PointOut].xCoord;
-         double x3 = Points[Tubes[j].PointIn].xCoord;
-         double x4 = Points[Tubes[j].PointOut].xCoord;
-         double y1 = Points[Tubes[i].PointIn].yCoord;
-         double y2 = Points[Tubes[i].PointOut].yCoord;
-         double y3 = Points[Tubes[j].PointIn].yCoord;
-         double y4 = Points[Tubes[j].PointOut].yCoord;
-         double z1 = Points[Tubes[i].PointIn].zCoord;
-         double z2 = Points[Tubes[i].PointOut].zCoord;
-         double z3 = Points[Tubes[j].PointIn].zCoord;
-         double z4 = Points[Tubes[j].PointOut].zCoord;
-
-         double diff21x = x2 - x1;
-         double diff21y = y2 - y1;
-         double diff21z = z2 - z1;
-
-         double diff43x = x4 - x3;
-         double diff43y = y4 - y3;
-         double diff43z = z4 - z3;
-
-         double diff31x = x3 - x1;
-         double diff31y = y3 - y1;
-         double diff31z = z3 - z1;
-
-         double cx = diff21y * diff43z - diff21z * diff43y;
-         double cy = diff21z * diff43x - diff21x * diff43z;
-         double cz = diff21x * diff43y - diff21y * diff43x;
-         /// distance between 2 tubes is a fraction expression. It can only be 0 if numerator is 0 and denominator is not 0
-         double numerator = diff31x * cx + diff31y * cy + diff31z * cz;
-         double denominator = sqrt(cx * cx + cy * cy + cz * cz);
-         if (fabs(denominator) < 1e-9) {
-            continue;
-         }
-         else {
-            double dist = numerator / denominator;
-            if (fabs(dist) < 1e-3) { /// distance between straight lines is 0 -> intersection or co-linear
-               bool isCx = (fabs(cx) > fabs(cy) && fabs(cx) > fabs(cz));
-               bool isCy = (fabs(cy) > fabs(cx) && fabs(cy) > fabs(cz));
-               bool isCz = (fabs(cz) > fabs(cx) && fabs(cz) > fabs(cy)); 
-               if (isCy) {
-                  t = (diff31x * diff43z - diff43x * diff31z) / -cy;
-                  u = (diff31x * diff21z - diff21x * diff31z) / -cy;
-                  if (t >= 0. && t <= 1. && u >= 0. && u <= 1.) {
-                     Intersection.xCoord = x1 + t * diff21x;
-                     Intersection.yCoord = y1 + t * diff21y;
-                     Intersection.zCoord = z1 + t * diff21z;
-                     Intersect.push_back(Intersection);
-                  }
-               }
-               else if (isCx) {
-                  t = (diff31z * diff43y - diff43z * diff31y) / -cx;
-                  u = (diff31z * diff21y - diff21z * diff31y) / -cx;
-                  if (t >= 0. && t <= 1. && u >= 0. && u <= 1.) {
-                     Intersection.xCoord = x1 + t * diff21x;
-                     Intersection.yCoord = y1 + t * diff21y;
-                     Intersection.zCoord = z1 + t * diff21z;
-                     Intersect.push_back(Intersection);
-                  }
-               }
-               else if(isCz) {
-                  t = (diff31x * diff43y - diff43x * diff31y) / cz;
-                  u = (diff31x * diff21y - diff21x * diff31y) / cz;
-                  if (t >= 0. && t <= 1. && u >= 0. && u <= 1.) {
-                     Intersection.xCoord = x1 + t * diff21x;
-                     Intersection.yCoord = y1 + t * diff21y;
-                     Intersection.zCoord = z1 + t * diff21z;
-                     Intersect.push_back(Intersection);
-                  }
-               }
+   size_t NoTubes = mTb + 1;
+   if (mTb == MINUS1 || NoTubes < 2) return 0;
+   vector<_box> Boxes(NoTubes);
+   for (size_t i = 0; i < NoTubes; i++) {
+      Boxes[i].set(Points[Tubes[i].PointIn], Points[Tubes[i].PointOut]);
+   }
+   _bvh Hierarchy;
+   Hierarchy.build(Boxes);
+
+   vector<vector<_point>> TubeIntersect(NoTubes);
+   int NoTb = static_cast<int> (NoTubes);
+#pragma omp parallel
+   {
+      vector<size_t> Candidates;
+      _point Intersection;
+#pragma omp for schedule(dynamic, 64)
+      for (int i = 0; i < NoTb; i++) {
+         Candidates.clear();
+         Hierarchy.query(Boxes, Boxes[i], Candidates);
+         sort(Candidates.begin(), Candidates.end());
+         for (const size_t j : Candidates) {
+            if (j <= static_cast<size_t> (i)) continue;
+            if (intersect_tubes(Tubes[i], Tubes[j], Points, Intersection)) {
+               TubeIntersect[i].push_back(Intersection);
             }
          }
       }
    }
+   for (const auto& iIntersect : TubeIntersect) {
+      Intersect.insert(Intersect.end(), iIntersect.begin(), iIntersect.end());
+   }
    return 0;
 }
-
@@ -11,12 +11,147 @@
  /* Created on November 23, 2016, 7:09 PM  */
 
 #include "common.h"
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+#include "../../wsc/source/modelFile.h"
 
 size_t mTb; ///< max index of tubes (max number of tubes - 1)
 size_t mPt; ///< max index of Points (number of points - 1)  
 
 using namespace std;
 
+/// options from command line or configuration file (--config=file): name without "--" and value, input that is given here is not asked on console
+map<string, string> Options;
+/// batch mode (option --batch): nothing is read from console, missing input stops the program with exit code 3
+bool isBatch = false;
+
+/**
+ * \brief reads the options of a configuration file
+ *
+ * each line is an option without the leading "--" (f.i. maxit=100 or batch), the project name is given by project=name,
+ * empty lines and lines starting with # are ignored
+ * \param FileName name of the configuration file
+ * \return false if the file cannot be opened
+ */
+bool ReadConfig(const string& FileName) {
+	ifstream Config(FileName);
+	if (!Config) {
+		return false;
+	}
+	string Line;
+	while (getline(Config, Line)) {
+		Line.erase(0, Line.find_first_not_of(" \t"));
+		Line.erase(Line.find_last_not_of(" \t\r") + 1);
+		if (Line.empty() || Line[0] == '#') {
+			continue;
+		}
+		size_t Equal = Line.find('=');
+		Options[Line.substr(0, Equal)] = Equal == string::npos ? "" : Line.substr(Equal + 1);
+	}
+	return true;
+}
+
+/**
+ * \brief input of a value: from option Name if given, otherwise asked on console
+ *
+ * in batch mode a missing option stops the program with exit code 3, as well as a value that cannot be read
+ * \param Name name of the option (without "--")
+ * \param Prompt text shown on console before reading the value
+ * \param Value [out] value read
+ */
+template <class T> void Input(const string& Name, const string& Prompt, T& Value) {
+	auto Option = Options.find(Name);
+	if (Option != Options.end()) {
+		istringstream Text(Option->second);
+		if (!(Text >> Value)) {
+			cout << "\n wrong value of option --" << Name << "=" << Option->second << endl;
+			exit(3);
+		}
+	}
+	else if (isBatch) {
+		cout << "\n option --" << Name << " missing in batch mode" << endl;
+		exit(3);
+	}
+	else {
+		cout << Prompt;
+		cin >> Value;
+	}
+}
+
+/**
+ * \struct GridCell
+ * \brief cell of uniform grid of points, the cell size is the tolerance of point coordinates (1 mm)
+ */
+struct GridCell {
+	int64_t ix; ///< cell index in x-direction
+	int64_t iy; ///< cell index in y-direction
+	int64_t iz; ///< cell index in z-direction
+	bool operator==(const GridCell& other) const { return ix == other.ix && iy == other.iy && iz == other.iz; }
+};
+/**
+ * \struct GridCellHash
+ * \brief hash function for GridCell
+ */
+struct GridCellHash {
+	size_t operator()(const GridCell& cell) const {
+		uint64_t h = static_cast<uint64_t>(cell.ix) * 0x9E3779B97F4A7C15ULL;
+		h ^= static_cast<uint64_t>(cell.iy) * 0xC2B2AE3D27D4EB4FULL + (h << 6) + (h >> 2);
+		h ^= static_cast<uint64_t>(cell.iz) * 0x165667B19E3779F9ULL + (h << 6) + (h >> 2);
+		return static_cast<size_t>(h);
+	}
+};
+/// points in each cell of the uniform grid, all points closer than 1 mm to a given point are in the 27 cells around it
+unordered_map<GridCell, vector<size_t>, GridCellHash> PointGrid;
+/// tubes (lines and arcs) with the key of their pair of points regardless of direction, to find lines on top of each other
+unordered_map<uint64_t, vector<size_t>> TubesByPoints;
+
+/**
+ * \brief cell of uniform grid the coordinates are in
+ */
+GridCell CellOf(double px, double py, double pz) {
+	return { static_cast<int64_t>(floor(px)), static_cast<int64_t>(floor(py)), static_cast<int64_t>(floor(pz)) };
+}
+
+/**
+ * \brief key of a pair of points, same key for both directions
+ */
+uint64_t PointPairKey(size_t iPt1, size_t iPt2) {
+	if (iPt1 > iPt2) swap(iPt1, iPt2);
+	return (static_cast<uint64_t>(iPt1) << 32) | static_cast<uint64_t>(iPt2);
+}
+
+/**
+ * \brief finds all points closer than 1 mm in each coordinate to the given coordinates
+ *
+ * \param px x-coordinate of point
+ * \param py y-coordinate of point
+ * \param pz z-coordinate of point
+ * \param Points vector of points
+ * \param Near point numbers found, in ascending order
+ */
+void PointsNear(double px, double py, double pz, const vector<_point>& Points, vector<size_t>& Near) {
+	GridCell center = CellOf(px, py, pz);
+	Near.clear();
+	for (int64_t dx = -1; dx <= 1; dx++) {
+		for (int64_t dy = -1; dy <= 1; dy++) {
+			for (int64_t dz = -1; dz <= 1; dz++) {
+				auto cell = PointGrid.find({ center.ix + dx, center.iy + dy, center.iz + dz });
+				if (cell == PointGrid.end()) continue;
+				for (const auto& iPt : cell->second) {
+					if (fabs(Points[iPt].xCoord - px) < 1. &&
+						fabs(Points[iPt].yCoord - py) < 1. &&
+						fabs(Points[iPt].zCoord - pz) < 1.) {
+						Near.push_back(iPt);
+					}
+				}
+			}
+		}
+	}
+	sort(Near.begin(), Near.end());
+}
+
 extern int DXFWrite(ostream& outData,
 	vector <_tube>& Tubes, size_t mTb,
 	vector <_point>& Points, size_t mPt);
@@ -118,12 +253,11 @@ void ProcessError(int NoLineDxf, double p1x, double p2x, double p1y, double p2y,
  * \return index of point in Points vector
  */
 size_t AddPointIfNotExist(double px, double py, double pz, vector<_point>& Points) {
-	for (size_t iPt = 0; iPt <= mPt; iPt++) {
-		if (fabs(Points[iPt].xCoord - px) < 1. &&
-			fabs(Points[iPt].yCoord - py) < 1. &&
-			fabs(Points[iPt].zCoord - pz) < 1.) {
-			return iPt;
-		}
+	static vector<size_t> Near;
+	// the point with lowest number within tolerance is taken, searched in neighbouring cells of grid only
+	PointsNear(px, py, pz, Points, Near);
+	if (!Near.empty()) {
+		return Near[0];
 	}
 	// not found in Point vector -> add
 	Points.push_back(_point());
@@ -131,6 +265,7 @@ size_t AddPointIfNotExist(double px, double py, double pz, vector<_point>& Point
 	Points[mPt].xCoord = px;
 	Points[mPt].yCoord = py;
 	Points[mPt].zCoord = pz;
+	PointGrid[CellOf(px, py, pz)].push_back(mPt);
 	return mPt;
 }
 
@@ -327,8 +462,23 @@ bool isTubeCorrect(double p1x, double p1y, double p1z, double p2x, double p2y, d
 	}
 	// -------------------------------------------            
 	//check if this line already exists (2 lines on top of each other)
+	// only tubes with points near both ends are candidates
 	// -------------------------------------------
-	for (size_t iTb = 0; iTb < mTb; iTb++) {
+	vector<size_t> NearIn, NearOut, Candidates;
+	PointsNear(p1x, p1y, p1z, Points, NearIn);
+	PointsNear(p2x, p2y, p2z, Points, NearOut);
+	for (const auto& iPtIn : NearIn) {
+		for (const auto& iPtOut : NearOut) {
+			auto PairTubes = TubesByPoints.find(PointPairKey(iPtIn, iPtOut));
+			if (PairTubes != TubesByPoints.end()) {
+				Candidates.insert(Candidates.end(), PairTubes->second.begin(), PairTubes->second.end());
+			}
+		}
+	}
+	sort(Candidates.begin(), Candidates.end());
+	Candidates.erase(unique(Candidates.begin(), Candidates.end()), Candidates.end());
+	for (const size_t iTb : Candidates) {
+		if (iTb >= mTb) break;
 		size_t iPtIn = Tubes[iTb].PointIn;
 		size_t iPtOut = Tubes[iTb].PointOut;
 		if ((fabs(Points[iPtIn].xCoord - p1x) < 1. &&
@@ -347,10 +497,17 @@ bool isTubeCorrect(double p1x, double p1y, double p1z, double p2x, double p2y, d
 				//if lines (Tubes) are identical. ignore it but ask for confirmation
 				// just to remind that the design is not 100% clean
 				cout << "\nidentical lines (tubes) found and ignored" << endl;
+				// in batch mode they are ignored, if not shown by option --identical-lines=s
+				if (isBatch && Options.count("identical-lines") == 0) {
+					Options["identical-lines"] = "y";
+				}
 				do {
-					cout << "please confirm (Yes/Show in error file)[y/s] :";
-					cin >> confirm;
+					Input("identical-lines", "please confirm (Yes/Show in error file)[y/s] :", confirm);
 					confirm = confirm & '\xdf';
+					if (confirm != 'Y' && confirm != 'S' && Options.count("identical-lines")) {
+						cout << "\n wrong value of option --identical-lines, y or s" << endl;
+						exit(3);
+					}
 				} while (confirm != 'Y' && confirm != 'S');
 				mTb--;
 				Tubes.pop_back();
@@ -385,6 +542,7 @@ bool isTubeCorrect(double p1x, double p1y, double p1z, double p2x, double p2y, d
 	//set number of inlet and outlet point, check if they already exist
 	Tubes[mTb].PointIn = AddPointIfNotExist(p1x, p1y, p1z, Points);
 	Tubes[mTb].PointOut = AddPointIfNotExist(p2x, p2y, p2z, Points);
+	TubesByPoints[PointPairKey(Tubes[mTb].PointIn, Tubes[mTb].PointOut)].push_back(mTb);
 
 	//parse of LayerInfo
 	//the layername contains all information 
@@ -451,11 +609,94 @@ bool isTubeCorrect(double p1x, double p1y, double p1z, double p2x, double p2y, d
 	return true;
 }
 
+/**
+ * \brief writes the binary model file (option --wscb), read by wsc instead of the data file
+ *
+ * the values are not rounded as in the data file, the geometry of the tubes is calculated by wscbGeometry as in wsc,
+ * the mesh is added by wsc in the first calculation. Layout see modelFile.h
+ * \param FileName name of the file (*projectname*.wscb)
+ * \param BaseData base data, units as used in wsc
+ * \param Tubes all tubes
+ * \param Points all points
+ * \return false if the file cannot be written
+ */
+bool WriteModelFile(const string& FileName, const _wscbBase& BaseData, const vector<_tube>& Tubes, const vector<_point>& Points) {
+	_wscbHeader Header{};
+	string Data;
+	auto Append = [&Data](const void* Record, size_t Size) {
+		Data.append(static_cast<const char*>(Record), Size);
+	};
+
+	if (!wscbIsLittleEndian()) {
+		cout << "\n binary model file can only be written on little-endian computers" << endl;
+		return false;
+	}
+	memcpy(Header.Id, WscbId, sizeof(WscbId));
+	Header.Version = WscbVersion;
+	Header.ByteOrder = WscbByteOrder;
+	Header.NoPoints = Points.size();
+	Header.NoTubes = Tubes.size();
+	Append(&BaseData, sizeof(BaseData));
+	for (size_t iPt = 0; iPt < Points.size(); iPt++) {
+		_wscbPoint Record{ iPt, Points[iPt].xCoord, Points[iPt].yCoord, Points[iPt].zCoord };
+		Append(&Record, sizeof(Record));
+	}
+	for (size_t iTb = 0; iTb < Tubes.size(); iTb++) {
+		const _tube& Tube = Tubes[iTb];
+		const _point& PtIn = Points[Tube.PointIn];
+		const _point& PtOut = Points[Tube.PointOut];
+		_wscbTube Record{};
+		Record.Number = iTb;
+		Record.PointIn = Tube.PointIn;
+		Record.PointOut = Tube.PointOut;
+		wscbGeometry(Tube.dOut, Tube.Thickness, Tube.RadiusBend, PtOut.xCoord - PtIn.xCoord, PtOut.yCoord - PtIn.yCoord,
+			PtOut.zCoord - PtIn.zCoord, Tube.OCSStartAngle, Tube.OCSEndAngle, Record);
+		Record.NoParallel = Tube.NoParallel;
+		Record.ksiAdd = Tube.ksiAdd;
+		Record.q = Tube.q;
+		Record.FactHeat = Tube.FactHeat;
+		Record.DiaOrificeIn = Tube.DiaOrificeIn / 1e3; // ->m
+		Record.DiaOrificeOut = Tube.DiaOrificeOut / 1e3; // ->m
+		Record.EnthInGiven = Tube.EnthGiven;
+		Record.OCSStartAngle = Tube.OCSStartAngle;
+		Record.OCSEndAngle = Tube.OCSEndAngle;
+		Record.OCSCenterX = Tube.OCSCenterX;
+		Record.OCSCenterY = Tube.OCSCenterY;
+		Record.OCSCenterZ = Tube.OCSCenterZ;
+		Record.Nx = Tube.Nx;
+		Record.Ny = Tube.Ny;
+		Record.Nz = Tube.Nz;
+		Append(&Record, sizeof(Record));
+	}
+	size_t NamesBegin = Data.size();
+	for (const auto& Tube : Tubes) {
+		uint32_t Length = static_cast<uint32_t>(Tube.Name.size());
+		Append(&Length, sizeof(Length));
+		Data += Tube.Name;
+	}
+	Data.resize((Data.size() + 7) / 8 * 8, '\0');
+	Header.SizeNames = Data.size() - NamesBegin;
+	Header.InputHash = wscbHash(Data.data(), Data.size());
+
+	ofstream outModel(FileName.c_str(), ios::binary);
+	outModel.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	outModel.write(Data.data(), Data.size());
+	if (!outModel.good()) {
+		cout << "\n cannot write file " << FileName << endl;
+		return false;
+	}
+	return true;
+}
+
 /**
  *
  * @param argc
- * @param argv can contain the project name, if empty user will be asked for file name
- * @return
+ * @param argv can contain the project name, if empty user will be asked for file name\n
+ * and options: --config=file for options from a configuration file (the command line overrides them), --batch for no input from console,
+ * --name=value for the input otherwise asked on console (maxit, tol, control, method, pressure, roughness, level-factor, level-drum, dp-drum, cr-start,
+ * identical-lines, bidrum, steam-drum-diameter, steam-drum-thickness, mud-drum-x, mud-drum-y, mud-drum-z, mud-drum-diameter, mud-drum-thickness),
+ * --wscb to write the binary model file (*projectname*.wscb) in addition to the data file
+ * @return exit code: 0 data file written, 1 file cannot be opened or read, 2 dxf file contains errors (see error file), 3 wrong option or input missing in batch mode
  */
 int main(int argc, char** argv) {
 	/* Local variables */
@@ -526,18 +767,43 @@ int main(int argc, char** argv) {
 	Points[DRUM].xCoord = 100000.;
 	Points[DRUM].yCoord = 100000.;
 	Points[DRUM].zCoord = 100000.;
+	PointGrid[CellOf(Points[DRUM].xCoord, Points[DRUM].yCoord, Points[DRUM].zCoord)].push_back(DRUM);
 
 	/*
 	 * reading project name if not already passed as argument and
 	 *  determine the name of input and output file
 	 */
-	if (argc > 1) {
-		Project = argv[1];
+	// options of configuration files first, so that the command line overrides them
+	for (int iArg = 1; iArg < argc; iArg++) {
+		string Arg = argv[iArg];
+		if (Arg.rfind("--config=", 0) == 0 && !ReadConfig(Arg.substr(9))) {
+			cout << "\n cannot open configuration file " << Arg.substr(9) << endl;
+			exit(3);
+		}
 	}
-	else {
-		cout << "\nProject name : ";
-		cin >> Project;
+	for (int iArg = 1; iArg < argc; iArg++) {
+		string Arg = argv[iArg];
+		if (Arg.rfind("--", 0) == 0) {
+			size_t Equal = Arg.find('=');
+			Options[Arg.substr(2, Equal == string::npos ? string::npos : Equal - 2)] = Equal == string::npos ? "" : Arg.substr(Equal + 1);
+		}
+		else {
+			Options["project"] = Arg;
+		}
+	}
+	isBatch = Options.count("batch") > 0;
+	Options.erase("batch");
+	Options.erase("config");
+	for (const auto& Option : Options) {
+		static const vector<string> Known = { "project", "maxit", "tol", "control", "method", "pressure", "roughness",
+			"level-factor", "level-drum", "dp-drum", "cr-start", "identical-lines", "bidrum", "steam-drum-diameter",
+			"steam-drum-thickness", "mud-drum-x", "mud-drum-y", "mud-drum-z", "mud-drum-diameter", "mud-drum-thickness", "wscb" };
+		if (find(Known.begin(), Known.end(), Option.first) == Known.end()) {
+			cout << "\n unknown option --" << Option.first << endl;
+			exit(3);
+		}
 	}
+	Input("project", "\nProject name : ", Project);
 //		filename = "..\\WSCDATA\\" + Project + "\\" + Project;
  //    filename = "..\\..\\WSCDATA\\" + Project + "\\" + Project;
 	filename = "WSCDATA\\" + Project + "\\" + Project;
@@ -729,30 +995,26 @@ int main(int argc, char** argv) {
 		cout << "\n in bi-drum boilers there is a big number of pseudo tubes in the drums ";
 		cout << "\n those can be generated automatically ";
 		do {
-			cout << "\n Is it a model for bi-drum boiler [y/n]?";
-			cin >> confirm;
+			Input("bidrum", "\n Is it a model for bi-drum boiler [y/n]?", confirm);
 			confirm = confirm & '\xdf';
+			if (!(confirm == 'Y' || confirm == 'N') && Options.count("bidrum")) {
+				cout << "\n wrong value of option --bidrum, y or n" << endl;
+				exit(3);
+			}
 		} while (!(confirm == 'Y' || confirm == 'N'));
 		if (confirm == 'Y') {
 			double SteamDrumDiameter, SteamDrumThickness, MudDrumDiameter, MudDrumThickness,
 				mdx, mdy, mdz;
 			size_t mdp;
 			// center point of steam drum already given; orientation of drum unknown 
-			cout << "\n please give steam drum outside diameter [mm] :";
-			cin >> SteamDrumDiameter;
-			cout << "\n please give steam drum shell thickness [mm] :";
-			cin >> SteamDrumThickness;
-
-			cout << "\n please give x-coordinate of mud drum center point [mm] :";
-			cin >> mdx;
-			cout << "\n please give y-coordinate of mud drum center point [mm] :";
-			cin >> mdy;
-			cout << "\n please give z-coordinate of mud drum center point [mm] :";
-			cin >> mdz;
-			cout << "\n please give mud drum outside diameter [mm] :";
-			cin >> MudDrumDiameter;
-			cout << "\n please give mud drum shell thickness [mm] :";
-			cin >> MudDrumThickness;
+			Input("steam-drum-diameter", "\n please give steam drum outside diameter [mm] :", SteamDrumDiameter);
+			Input("steam-drum-thickness", "\n please give steam drum shell thickness [mm] :", SteamDrumThickness);
+
+			Input("mud-drum-x", "\n please give x-coordinate of mud drum center point [mm] :", mdx);
+			Input("mud-drum-y", "\n please give y-coordinate of mud drum center point [mm] :", mdy);
+			Input("mud-drum-z", "\n please give z-coordinate of mud drum center point [mm] :", mdz);
+			Input("mud-drum-diameter", "\n please give mud drum outside diameter [mm] :", MudDrumDiameter);
+			Input("mud-drum-thickness", "\n please give mud drum shell thickness [mm] :", MudDrumThickness);
 			mdp = AddPointIfNotExist(mdx, mdy, mdz, Points);
 
 			// checking steam drum first  
@@ -809,52 +1071,47 @@ int main(int argc, char** argv) {
 			outData.close();
 			cout << "\n dxf file contains errors \nPlease check " << writefile << " for position of the errors ";
 		}//file opened correctly
+		return 2;
 
 	}
 	else {
 		// if geometry is ok, input base data like drum pressure, calculation method etc
-		cout << "\n maximum number of iterations ";
-		cin >> maxit;
-		cout << "\n tolerance ";
-		cin >> tolerance;
-		cout << "\n control parameter for protocol file :";
-		cout << "\n show nothing: 0 ";
-		cout << "\n show info about mesh/network : 1 ";
-		cout << "\n show info about calculation of enthalpy at branches inlet : 2 ";
-		cout << "\n show info about pressure drop in tubes : 3 ";
-		cout << "\n show info about pressure drop in branches :5 ";
-		cout << "\n show info about nodal pressure calculation : 6 ";
-		cout << "\n show info and .dxf about flow for next iteration step : 7 ";
-		cout << "\n show info reversal of flow direction in branches and tubes : 8 ";
-		cout << "\n show all info (careful, protocol file can get HUGE) : 10  : ";
-		cout << "\n show more details about mesh/network : 11 ";
-		cout << "\n show more details about pressure drop in tubes : 13 ";
-		cout << "\n show more info reversal of flow direction in branches and tubes : 18 ";
-		cout << "\n show everything (careful, protocol file can get really HUGE) : 20 : ";
-		cin >> control;
+		Input("maxit", "\n maximum number of iterations ", maxit);
+		Input("tol", "\n tolerance ", tolerance);
+		Input("control", "\n control parameter for protocol file :"
+			"\n show nothing: 0 "
+			"\n show info about mesh/network : 1 "
+			"\n show info about calculation of enthalpy at branches inlet : 2 "
+			"\n show info about pressure drop in tubes : 3 "
+			"\n show info about pressure drop in branches :5 "
+			"\n show info about nodal pressure calculation : 6 "
+			"\n show info and .dxf about flow for next iteration step : 7 "
+			"\n show info reversal of flow direction in branches and tubes : 8 "
+			"\n show all info (careful, protocol file can get HUGE) : 10  : "
+			"\n show more details about mesh/network : 11 "
+			"\n show more details about pressure drop in tubes : 13 "
+			"\n show more info reversal of flow direction in branches and tubes : 18 "
+			"\n show everything (careful, protocol file can get really HUGE) : 20 : ", control);
 		do {
-			cout << "\n calculation method for 2-phase density and pressure drop"
-				<< "\n J for Jirous/Jirous"
-				<< "\n R for Rouhani/Becker"
-				<< "\n E for Chexal/VDIHeatAtlas "
-				<< "\n W for Welzer/Welzer "
-				<< "\n C for Woldesemayat/VDIHeatAtlas ";
-			cin >> Method;
+			Input("method", "\n calculation method for 2-phase density and pressure drop"
+				"\n J for Jirous/Jirous"
+				"\n R for Rouhani/Becker"
+				"\n E for Chexal/VDIHeatAtlas "
+				"\n W for Welzer/Welzer "
+				"\n C for Woldesemayat/VDIHeatAtlas ", Method);
 			Method = Method & '\xdf';
+			if (!(Method == 'J' || Method == 'R' || Method == 'E' || Method == 'W' || Method == 'C') && Options.count("method")) {
+				cout << "\n wrong value of option --method, J, R, E, W or C" << endl;
+				exit(3);
+			}
 		} while (!(Method == 'J' || Method == 'R' || Method == 'E' || Method == 'W' || Method == 'C'));
-		cout << "\n drum pressure [MPag] ";
-		cin >> pressure;
-		cout << "\n tube roughness [mm] ";
-		cin >> roughness;
-		cout << "\n LevelFactor between highest and lowest heated point ";
-		cout << "\n downcomers have to pass through this level, 0 ... 1 ";
-		cin >> LevelFact;
-		cout << "\n Water level in drum, difference to drum center [mm] ";
-		cin >> LevelWDrum;
-		cout << "\n Resistance of drum internals [kPa] ";
-		cin >> dpDynDrum;
-		cout << "\n Circulation ratio for start values \n     a number between 10 and 30 would be a good initial guess ";
-		cin >> CRStart;
+		Input("pressure", "\n drum pressure [MPag] ", pressure);
+		Input("roughness", "\n tube roughness [mm] ", roughness);
+		Input("level-factor", "\n LevelFactor between highest and lowest heated point "
+			"\n downcomers have to pass through this level, 0 ... 1 ", LevelFact);
+		Input("level-drum", "\n Water level in drum, difference to drum center [mm] ", LevelWDrum);
+		Input("dp-drum", "\n Resistance of drum internals [kPa] ", dpDynDrum);
+		Input("cr-start", "\n Circulation ratio for start values \n     a number between 10 and 30 would be a good initial guess ", CRStart);
 		//  save to circulation data file 
 		outData.open(writefile.c_str());
 		outData << filename << endl; // project name == filename
@@ -895,6 +1152,14 @@ int main(int argc, char** argv) {
 			<< setw(9) << setprecision(6) << Tubes[iTb].Nz << "\n";
 		}
 		outData.close();
+		if (Options.count("wscb")) {
+			// the same data without rounding, wsc reads it instead of the data file
+			_wscbBase BaseData{ maxit, control, Method, tolerance, pressure + 0.1, roughness / 1e3, LevelFact,
+				LevelWDrum, dpDynDrum * 1e3, CRStart };
+			if (!WriteModelFile(filename + ".wscb", BaseData, Tubes, Points)) {
+				exit(1);
+			}
+		}
 
 		//writing tube numbers, point numbers as layer names in dxf-file
 		NoLineDxf = 0;
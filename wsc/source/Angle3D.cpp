@@ -4,7 +4,11 @@
 /*     function determines spatial angle between *this tube and other tube */
 /* ----------------------------------------------------------------------- */
 
-double _tube::Angle3d(const _tube& other) {
+double _tube::Angle3d(const _tube& other) const {
+	return acos(Cos3d(other));
+} /* spatial angle in radians */
+
+double _tube::Cos3d(const _tube& other) const {
 	double arg;
 	arg = (Points[this->PointOut].xCoord - Points[this->PointIn].xCoord) / this->Length / 1e3 *
 		((Points[other.PointOut].xCoord - Points[other.PointIn].xCoord) / other.Length / 1e3) +
@@ -14,11 +18,11 @@ double _tube::Angle3d(const _tube& other) {
 		((Points[other.PointOut].zCoord - Points[other.PointIn].zCoord) / other.Length / 1e3);
 	if (fabs(arg) > 1.01) {
 		cout << "\n error calculating angle between tube " << this->Number << " and " << other.Number;
-		exit(1);
+		throw _wscError("error calculating angle between tube " + to_string(this->Number) + " and " + to_string(other.Number));
 	}
 	if (arg > 1.) arg = 1.;
 	else if (arg < -1.) arg = -1.;
 
-	return acos(arg);
-} /* spatial angle in radians */
+	return arg;
+} /* cosine of spatial angle */
 
@@ -13,8 +13,11 @@
 #include <stdlib.h>
 #include <iomanip>
 #include <vector>
+#include <algorithm>
 #include <stdexcept>
 #include <system_error>
+#include <atomic>
+#include <cstdint>
 //#include <Eigen/Dense>
 #include <Eigen/Sparse>
 //#include<Eigen/IterativeLinearSolvers>
@@ -24,6 +27,7 @@
 #define _USE_MATH_DEFINES
 #endif
 #include "propH2O.h"
+#include "Dual.h"
 using namespace std;
 using namespace Eigen;
 
@@ -50,48 +54,72 @@ using stVector = std::vector<size_t>;
 /// No.. number of (count), how many
 /// Nb.. specific number of tube, branch etc.
 
-/*!
-\var size_t mBr; 
-\brief max index of branches (number of branches - 1)
-*/
-EXTERN size_t mBr; // max index of branches (number of branches - 1)
+class _circulationModel;
 
 /*!
-\var size_t mTb; 
-\brief max index of tubes (number of tubes - 1)
-*/
-EXTERN size_t mTb; // max index of tubes (number of tubes - 1)
-/*!
-\var size_t mPt; 
-\brief max index of Points (number of points - 1)
-*/
-EXTERN size_t mPt; // max index of Points (number of points - 1)
-
-/*!
-\var size_t mNd; 
-\brief max index of nodes (number of nodes - 1)
-*/
-EXTERN size_t mNd; // max index of nodes (number of nodes - 1)
-
-/*!
-\var string PathFile
-\brief full path to working directory as well as project name
+* \class _wscError
+* \brief error that stops the calculation of a model
+*
+* thrown instead of terminating the program, the message is written to console and protocol before\n
+* Code is the exit code of the program (1: input or calculation error, -1: pressure out of range)
 */
-EXTERN string PathFile;
+class _wscError : public runtime_error {
+public:
+    int Code; ///< exit code
+    _wscError(const string& what, int code = 1) : runtime_error(what), Code(code) {}
+};
 
 /*!
-\var vector FileNames
-\brief vector of all file names produced during calculation, to be called for deletion
+* \class _protocol
+* \brief protocol file that can be written from several threads
+*
+* normally everything is written to the file\n
+* a thread can redirect its output to a buffer (setBuffer), f.i. during parallel calculation of branches.
+* The buffers are written to the file afterwards in the order of the branches, so the protocol looks the same as from a serial calculation,
+* also if the calculation of a branch stopped by an error (_wscError)
 */
-EXTERN vector<string> FileNames;
+class _protocol {
+public:
+	ofstream File; ///< protocol file
+	static inline thread_local ostringstream* Buffer = nullptr; ///< buffer of this thread, nullptr: write to file
+
+	void open(const char* name) { File.open(name); }
+	void close() { File.close(); }
+	void exceptions(ios_base::iostate except) { File.exceptions(except); }
+	/// sets buffer for output of calling thread, nullptr for output to file
+	void setBuffer(ostringstream* ThreadBuffer) { Buffer = ThreadBuffer; }
+	/// stream of calling thread
+	ostream& stream() {
+		if (Buffer != nullptr) return *Buffer;
+		return File;
+	}
+	template <typename T> ostream& operator<<(const T& value) { return stream() << value; }
+	ostream& operator<<(ostream& (*manip)(ostream&)) { return stream() << manip; }
+	ostream& operator<<(ios_base& (*manip)(ios_base&)) { return stream() << manip; }
+};
 
 /*!
-\var ofstream prot;
-\brief file handle for protocol file 
-
-used to trace data during calculation 
+* \class _mappedFile
+* \brief read-only view of a whole file mapped into memory
+*
+* the file is mapped at construction and unmapped at destruction, an empty file gives an empty view (data() is nullptr)\n
+* throws _wscError if the file cannot be opened or mapped
 */
-EXTERN ofstream prot;
+class _mappedFile {
+public:
+	explicit _mappedFile(const string& FileName);
+	~_mappedFile();
+	_mappedFile(const _mappedFile&) = delete;
+	_mappedFile& operator=(const _mappedFile&) = delete;
+	const char* data() const { return Data; } ///< first byte of the file
+	size_t size() const { return Size; }      ///< size of the file in bytes
+private:
+	const char* Data = nullptr;
+	size_t Size = 0;
+#ifdef _WIN32
+	void* Mapping = nullptr; ///< handle of the file mapping object
+#endif
+};
 
 /*!
 * \enum FlowPattern
@@ -210,6 +238,19 @@ enum class USArrangement
    U,  ///< U arrangement
 };
 
+/*!
+ * \enum SolverKind
+ * \brief outer iteration of the flow in branches
+ *
+ * selected by program argument --solver=fixedpoint, --solver=newton or --solver=anderson
+ */
+enum class SolverKind
+{
+   FixedPoint, ///< new flow from nodal pressures, damped with fixed factor (default)
+   Newton,     ///< new flow from nodal pressures is the Newton step, step length controlled by monotonicity test
+   Anderson    ///< damped fixed point with Anderson acceleration over the last Base.AndersonWindow steps
+};
+
 /*!
 * \class _base
 * \brief Base holds some basic values
@@ -221,6 +262,8 @@ public:
     double Rough;          ///< tube roughness in mm (valid for all tubes)
     double DowncomerLevel; ///< level that downcomers pass, determined by highest and lowest point and LevelFact (input)
     double CRStart;        ///< initial guess of circulation ratio for the first branch flow estimation initFlow() 
+    double LevelFact;      ///< factor for DowncomerLevel between lowest (0) and highest (1) point (input)
+    int Control;           ///< control number of the input for the protocol output, sets the show... switches
     bool showMesh;         ///< switch for printing of protocol showing mesh data
     bool showEnth;         ///< switch for printing of protocol showing enthalpy in nodes data
     bool showDPTube;       ///< switch for printing of protocol showing pressure difference in tubes
@@ -233,15 +276,22 @@ public:
     bool showDPTubeDetail; ///< switch for printing of protocol showing more details on pressure difference in tubes
     int iterg;             ///< counter for flow iterations
     int maxit;             ///< maximum flow iterations
+    size_t TopologyVersion;///< counter, increased if the connection of nodes by branches in NodeBranches changes -> new pattern of equation system
+    SolverKind Solver;     ///< outer iteration: fixed point with damping or Newton with step length control
+    size_t AndersonWindow; ///< number of previous steps used by Anderson acceleration
+    double SkipTol;        ///< relative tolerance: a branch whose inputs changed less keeps its previous calculation (dpAllBranches), 0: always calculated
+    double DpTol;          ///< tolerance of the pressure difference of a tube for the adaptive section length [Pa], 0: number of sections by DetermineNoSections()
+    double WaterFastTol;   ///< unheated tubes with subcooled water and pressure change below this share of inlet pressure are calculated in closed form, 0: never
+    int CheckpointEvery;   ///< the state of the iteration is saved to checkpoint file every n iteration steps, 0: only at convergence
+    bool isRestart;        ///< start values are read from checkpoint file RestartFile
+    string RestartFile;    ///< checkpoint file to start from, empty: checkpoint of this project
+    string SweepFile;      ///< case table of a load case sweep, empty: single calculation
+    int SweepThreads;      ///< number of load cases calculated at the same time, 0: number of hardware threads
+    bool isBatch;          ///< batch mode: nothing is read from console, missing input is an error
+    bool isAcceptMaxit;    ///< the result at the maximum number of iterations is accepted without asking
+    bool isKeepFiles;      ///< the intermediate/temporary files are kept without asking
     char Method;           ///< calculation method (J for Jirous/Jirous, W for Welzer/Welzer, R for Rouhani/Becker, C for Chexal,Lellouche/VDIHA,G for Woldesemayat/VDIHA
 };
-/*!
-\var _base Base
-\brief single invocation of structure _base 
-
-Base is holding some base values
-*/
-EXTERN _base Base;
 
 /*!
 * \struct _drum
@@ -260,11 +310,6 @@ struct _drum {
     double qSum;      ///< sum of all heat in the boiler in kW
     double FlowSteam; ///< steam flow from drum [kg/s]
 };
-/*
-\var  _drum Drum;
-\brief single invocation of structure -drum
-*/
-EXTERN _drum Drum;
 
 /*!
 * \class _point 
@@ -293,11 +338,39 @@ public:
     }
 };
 
+
 /*!
-\var vector <_point> Points;
-\brief vector holding all points (of class _point)
+* \class _sectionState
+* \brief state at the outlet of a tube section, it is the inlet state of the next section
+*
+* the adaptive section integration (dpSectionsAdaptive) keeps the state to calculate a section again from the same inlet
 */
-EXTERN vector <_point> Points;
+class _sectionState {
+public:
+    double enthInSect;      ///< inlet enthalpy [kJ/kg]
+    double enthOutSect;     ///< outlet enthalpy [kJ/kg]
+    bool PhaseChange;       ///< a phase change occurred in the section
+    double tSatOutSect;     ///< saturation temperature at outlet [K]
+    double volWOutSect;     ///< spec. volume of saturated water at outlet  [m3/kg]
+    double volSOutSect;     ///< spec. volume of saturated steam at outlet [m3/kg]
+    double SurfTensOutSect; ///< surface tension at outlet [N/m]
+    double dynVisSOutSect;  ///< dynamic viscosity of saturated steam at outlet [Pa s]
+    double dynVisWOutSect;  ///< dynamic viscosity of saturated water at outlet [Pa s]
+    double dynVisOutSect;   ///< dynamic viscosity at outlet [Pa s], single phase
+    double enthWSatOutSect; ///< spec. enthalpy of saturated water at outlet [kJ/kg]
+    double enthSSatOutSect; ///< spec. enthalpy of saturated steam at outlet [kJ/kg]
+    double pPaOutSect;      ///< absolute pressure at outlet [Pa]
+    double dpDynSect;       ///< dynamic pressure drop of the section [Pa]
+    double dpStatSect;      ///< static pressure difference of the section [Pa]
+    double xInSect;         ///< steam quality at inlet
+    double xOutSect;        ///< steam quality at outlet
+    double rhoInSect;       ///< density at inlet [kg/m3]
+    double rhoOutSect;      ///< density at outlet [kg/m3], 0 if there is no previous section
+    double VoidInSect;      ///< void fraction at inlet
+    double VoidOutSect;     ///< void fraction at outlet
+    double rhoMeanSect;     ///< mean density [kg/m3]
+    double VelSect;         ///< mean velocity [m/s]
+};
 
 /*!
 * \class _tube 
@@ -329,6 +402,8 @@ public:
     double LengthSection;  ///< Length of section [m]
     double HeightSection;  ///< Height of section [m]
     double HeatSection;    ///< heat absorption of one section of one tube [kW]
+    double LengthStep;     ///< step length proposed by the last adaptive section integration, start value of the next one [m], 0: none yet
+    int NoStepsAdaptive;   ///< number of sections of the last adaptive section integration
     double pPaIn;          ///< absolute pressure at tube inlet [Pa]
     double EnthIn;         ///< enthalpy at tube inlet [kJ/kg]
     double EnthInGiven;    ///< given enthalpy at tube inlet [kJ/kg], below drum saturation enthalpy to indicate distinct (even heated) downcomers 
@@ -346,6 +421,8 @@ public:
     double dpOut;          ///< pressure drop at outlet [Pa]
     double dpdyn;          ///< dynamic pressure difference [Pa]
     double dpstat;         ///< static pressure difference [Pa]
+    double dpDer;          ///< derivative of pressure difference (dpIn + dpdyn + dpstat + dpOut) with respect to flow of all parallel tubes [Pa s/kg]
+    bool isDpDerValid;     ///< dpDer is valid: tube unheated and single phase in all sections
     double rhoIn;          ///< density at inlet [kg/m3]
     double rhoOut;         ///< density at outlet [kg/m3]
     double rhoMean;        ///< mean density [kg/m3]
@@ -353,24 +430,11 @@ public:
     double MassVel;        ///< mass velocity in tube [kg/m2 s]
     //   double Reynolds; //Reynolds number
     double velWater;       ///< velocity if density is water density ("superficial" water velocity)[m/s]
-    double SafetyFactor;   ///< safety factor against flow separation or overheating (should be higher than 1)
-    double SafetyKorneev;   ///< safety factor against overheating according to Korneev
-    double SafetyTaitel_Dukler;  ///< safety factor against flow separation according to Taitel-Dukler
-    double SafetySteiner;   ///< safety factor against flow separation according to Steiner
-    double SafetyKonkov;   ///< safety factor against overheating according to Kon'kov
-    double SafetyDoroshchuk;   ///< safety factor against overheating according to Doroshchuk
-    double SafetyKatto_Ohno;   ///< safety factor against overheating according to Katto-Ohno
-    double SafetyGroeneveld;   ///< safety factor against overheating according to Groeneveld
+    double RelRough;       ///< relative roughness Base.Rough / Dia [-], set by setConstants()
+    double etaBendUS;      ///< correction factor of ksiBend for bends in U or S arrangement [-], set by setConstants()
+    double ksi0OrificeOut; ///< resistance factor of outlet orifice without Reynolds influence [-], set by setConstants()
+    double ksiPhiOrificeOut; ///< Reynolds independent factor 0.39 exp(-18.34 m1^3.5) of outlet orifice [-], set by setConstants()
     FlowPattern steiner;   ///< flow pattern according Steiner
-    double OCSStartAngle;  ///< start angle of arc (bend) in OCS, needed for .dxf file
-    double OCSEndAngle;    ///< start angle of arc (bend) in OCS, needed for .dxf file
-    double OCSCenterX;     ///< x-coordinate of arc (bend) center point in OCS, needed for .dxf output file
-    double OCSCenterY;     ///< y-coordinate of arc (bend) center point in OCS, needed for .dxf output file
-    double OCSCenterZ;     ///< z-coordinate of arc (bend) center point in OCS, needed for .dxf output file
-    double Nx;             ///< x-component of arc (bend) extrusion vector, needed for .dxf output file
-    double Ny;             ///< y-component of arc (bend) extrusion vector, needed for .dxf output file
-    double Nz;             ///< z-component of arc (bend) extrusion vector, needed for .dxf output file
-    std::string Name;      ///< name of the tube
 
     /// constructor
     _tube() {
@@ -388,6 +452,8 @@ public:
         LengthSection = 0.; // Length of section [m]
         HeightSection = 0.; // Height of section [m]
         HeatSection = 0.; // heat absorption of one section of one tube [kW]
+        LengthStep = 0.;
+        NoStepsAdaptive = 0;
         VoidFractionOut = 0.;
         Dia = 0.;
         area = 0.;
@@ -413,30 +479,19 @@ public:
         HeatFlux = 0.;
         dpdyn = 0.;
         dpstat = 0.;
+        dpDer = 0.;
+        isDpDerValid = false;
         rhoIn = 0.;
         rhoOut = 0.;
         rhoMean = 0.;
         Flow = 0.;
         MassVel = 0.;
         velWater = 0.;
-        SafetyFactor = -10.;
-        SafetyKorneev = -10.;
-        SafetyTaitel_Dukler = -10.;  
-        SafetySteiner = -10.;   
-        SafetyKonkov = -10.;   
-        SafetyDoroshchuk = -10.;   
-        SafetyKatto_Ohno = -10.;   
-        SafetyGroeneveld = -10.;  
+        RelRough = 0.;
+        etaBendUS = 0.;
+        ksi0OrificeOut = 0.;
+        ksiPhiOrificeOut = 0.;
         steiner = FlowPattern::undetermined;
-        OCSStartAngle = 0.;
-        OCSEndAngle = 0.;
-        OCSCenterX = 0.;
-        OCSCenterY = 0.;
-        OCSCenterZ = 0.;
-        Nx = 0.;
-        Ny = 0.;
-        Nz = 0.;
-        Name = " ";
     }
     //   functions
  /*!
@@ -448,7 +503,24 @@ public:
 * \param [in] other reference to other tube
 * \return spatial angle in radians
 */
-    double Angle3d(const _tube& other);
+    double Angle3d(const _tube& other) const;
+
+/*!
+*  \brief cosine of spatial angle between 2 tubes *this* and *other*, terminates the program if the tube data is inconsistent
+* \param [in] other reference to other tube
+* \return cosine of spatial angle, limited to -1...1
+*/
+    double Cos3d(const _tube& other) const;
+
+/*!
+* \brief sets the data of the tube that only depends on geometry (relative roughness, bend in U or S arrangement, outlet orifice)
+*
+* called in Mesh() and after reversal of flow direction, the pressure drop functions only calculate the flow dependent parts
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+*/
+    void setConstants();
 
 /*!
  * \brief Determines the number of sections of this tube
@@ -466,6 +538,51 @@ public:
      */
     void DetermineNoSections(double g);
 
+/*!
+* \brief the tube is long enough to be split into sections (straight tube longer than 2 * diameter, bend with r/D > 5)
+*/
+    bool isSectioned() const;
+
+/*!
+* \brief calculation of one section of the straight part of the tube with given length by dPSection
+*
+* LengthSection, HeightSection and HeatSection are set for this section
+* \param [in, out] Sect state at inlet of the section, on return state at its outlet
+* \param [in] LengthSect length of the section [m]
+* \return int error code of dPSection
+*/
+    int dPSectionLength(_sectionState& Sect, double LengthSect);
+
+/*!
+* \brief pressure difference of the straight part of the tube with section length controlled by the error estimate
+*
+* Each step is calculated once with its full length and once as two sections of half length (step doubling, both with dPSection).\n
+* The difference of the outlet pressures estimates the error of the step, the step is accepted if it is below Base.DpTol * step length / tube length\n
+* and the two half sections are used. The next step length is chosen from the error (the local error of the sections is of third order in length).\n
+* The last proposed step length is kept in LengthStep as start value for the next calculation of this tube (next flow or iteration step).
+* \param [in, out] Sect state at the inlet of the straight part, on return state at its outlet
+* \return int error code of dPSection
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+*/
+    int dpSectionsAdaptive(_sectionState& Sect);
+
+/*!
+* \brief pressure difference of the straight part of an unheated tube with subcooled water in closed form
+*
+* The spec. volume is linearised in pressure around the inlet state, the viscosity is kept at its inlet value.\n
+* Then the pressure difference of the whole straight part follows from one equation without sections and without iteration.\n
+* It is used only if the pressure changes less than Base.WaterFastTol * inlet pressure and the water stays subcooled,\n
+* otherwise Sect is unchanged and the sections have to be calculated.
+* \param [in, out] Sect state at the inlet of the straight part, on return state at its outlet
+* \return true if the closed form was used
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+*/
+    bool dpWaterClosedForm(_sectionState& Sect);
+
 /*!
 * \brief calculates the pressure difference in a tube
 *
@@ -480,6 +597,7 @@ public:
 * 
 * 
 * 
+* \param [in] Model model the tube belongs to, activated for the calculation
 * \param [in] ResFactIn resistance factor at inlet [-]
 * \param [in] ResFactOut resistance factor at outlet [-]
 * \param [in] g Flow in all parallel tubes [kg/s]
@@ -489,7 +607,7 @@ public:
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
 * \date   September 2021
 */
-    int dpTube ( double ResFactIn, double ResFactOut, double g );
+    int dpTube ( _circulationModel& Model, double ResFactIn, double ResFactOut, double g );
 
 /*!
 * \brief calculation of pressure difference in tube section
@@ -621,7 +739,8 @@ public:
 /*!
 * \brief dPTwoPhase calculates the static and dynamic pressure difference of a tube section in 2 phase flow
 *
-* It is assumed that the tube sections are small enough that the properties are mean value between inlet and outlet
+* It is assumed that the tube sections are small enough that the properties are mean value between inlet and outlet\n
+* calls the instance of dPTwoPhaseMethod for the calculation method selected by SelectTwoPhaseMethod()
 * 
 * \param  [in] region indicating the region of the tube: single place (inlet, outlet etc.) is default but FrictCoeffAdd must be given, orifice, bend, tube
 * \param  [in] FrictCoeffAdd friction coefficient [-]if single place: friction coeff of this particular place, if tube: additional friction coeff
@@ -686,6 +805,24 @@ public:
         double& rhoMeanSect, // mean density [kg/m3]
         double& VelSect ); // mean velocity [m/s]
 
+/*!
+* \brief dPTwoPhase for one calculation method of 2-phase flow
+*
+* Method is a policy type (JirousPolicy, WelzerPolicy, RouhaniBeckerPolicy, ChexalHeatAtlasPolicy, WoldesemayatPolicy in dp2Phase.cpp)
+* giving density and dynamic pressure drop, thus there is no switch on Base.Method inside the section iteration\n
+* parameters as dPTwoPhase
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+   */
+    template <class Method>
+    int dPTwoPhaseMethod(TbRegion region, double FrictCoeffAdd, double enthIn, double enthOut, double LengthOrifice,
+        bool& PhaseChange, double& tSatOut, double& volWOut, double& volSOut, double& SurfTensOut,
+        double& dynVisSOut, double& dynVisWOut, double& enthWSatOut, double& enthSSatOut,
+        double& pPaOutSect, double& dpDynSect, double& dpStatSect, double& xInSect, double& xOutSect,
+        double& rhoInSect, double& rhoOutSect, double& VoidInSect, double& VoidOutSect,
+        double& rhoMeanSect, double& VelSect);
+
 /*!
 * \brief calculates the mixture density according to Chexal-Lellouche
 *
@@ -889,6 +1026,7 @@ public:
 * 
 * Source: I don't recall, where I found the formula. It is in **good** agreement with the diagram and no iteration needed.  
 *
+* \tparam T double or _dual (the derivative with respect to Reynolds is carried along)
 * \param [in] Reynolds Reynolds number
 * \param [in] RelRough relative Roughness (rough/dia) [-]
 * \return friction factor
@@ -897,13 +1035,14 @@ public:
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
 * \date   September 2021
     */
-    double FrictFact ( double Reynolds, double RelRough );
+    template <typename T> T FrictFact ( T Reynolds, double RelRough );
 
 /*!
 * \brief calculation of resistance factor for bends, elbows and sharp edged deflection
 *
 * Source: Idel'chik, Handbook of hydraulic resistance, Coefficients of local resistance and of friction
 * 
+* \tparam T double or _dual (the derivative with respect to Reynolds is carried along)
 * \param [in] Reynolds Reynolds number
 * \param [in] AngleDeg Bend angle [degrees] 
 * \return resistance factor
@@ -912,7 +1051,7 @@ public:
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
 * \date   September 2021
    */
-    double ksiBend ( double Reynolds, double AngleDeg );
+    template <typename T> T ksiBend ( T Reynolds, double AngleDeg );
 
 /*!
 * \brief calculates resistance factor of orifice
@@ -921,13 +1060,14 @@ public:
 *
 * \param [in] LengthOrifice length (thickness) of orifice
 * \param [in] visc dynamic viscosity of fluid [Pa s]
+* \param [in] MassVelocity mass velocity in tube [kg/m2 s], double or _dual (the derivative with respect to flow is carried along)
 * \return resistance factor
 * \author Rainer_Jordan@<very, very warm>mail.com
 * #### Licence
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
 * \date   September 2021
     */
-    double ksiOrifice ( double LengthOrifice, double visc );
+    template <typename T> T ksiOrifice ( double LengthOrifice, double visc, T MassVelocity );
 
 /*!
 * \brief function to determine safety factor against different criteria
@@ -944,12 +1084,13 @@ public:
 * Katto-Ohno is only valid for xIn <= 0\n
 *
 * the minimum safety factor is used
+* \param [in] Model model the tube belongs to, activated for the calculation
 * \author Rainer_Jordan@<very, very warm>mail.com
 * #### Licence
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
 * \date   September 2021
 */
-    void Criteria();
+    void Criteria(_circulationModel& Model);
 
 /*!
 * \brief critical heat flux according table from Groeneveld
@@ -1019,11 +1160,97 @@ public:
 
 };
 
+
 /*!
-\var vector <_tube> Tubes;
-\brief vector holding all tubes (of class _tube)
+* \class _tubeOutput
+* \brief data of a tube only needed for input/output: name, arc (bend) geometry for .dxf file and safety factors
+*
+* kept apart from _tube, thus the data used in the flow iteration of a tube is closer together in memory
 */
-EXTERN vector <_tube> Tubes;
+class _tubeOutput {
+public:
+    double SafetyFactor;   ///< safety factor against flow separation or overheating (should be higher than 1)
+    double SafetyKorneev;   ///< safety factor against overheating according to Korneev
+    double SafetyTaitel_Dukler;  ///< safety factor against flow separation according to Taitel-Dukler
+    double SafetySteiner;   ///< safety factor against flow separation according to Steiner
+    double SafetyKonkov;   ///< safety factor against overheating according to Kon'kov
+    double SafetyDoroshchuk;   ///< safety factor against overheating according to Doroshchuk
+    double SafetyKatto_Ohno;   ///< safety factor against overheating according to Katto-Ohno
+    double SafetyGroeneveld;   ///< safety factor against overheating according to Groeneveld
+    double OCSStartAngle;  ///< start angle of arc (bend) in OCS, needed for .dxf file
+    double OCSEndAngle;    ///< start angle of arc (bend) in OCS, needed for .dxf file
+    double OCSCenterX;     ///< x-coordinate of arc (bend) center point in OCS, needed for .dxf output file
+    double OCSCenterY;     ///< y-coordinate of arc (bend) center point in OCS, needed for .dxf output file
+    double OCSCenterZ;     ///< z-coordinate of arc (bend) center point in OCS, needed for .dxf output file
+    double Nx;             ///< x-component of arc (bend) extrusion vector, needed for .dxf output file
+    double Ny;             ///< y-component of arc (bend) extrusion vector, needed for .dxf output file
+    double Nz;             ///< z-component of arc (bend) extrusion vector, needed for .dxf output file
+    std::string Name;      ///< name of the tube
+
+    /// constructor
+    _tubeOutput() {
+        SafetyFactor = -10.;
+        SafetyKorneev = -10.;
+        SafetyTaitel_Dukler = -10.;
+        SafetySteiner = -10.;
+        SafetyKonkov = -10.;
+        SafetyDoroshchuk = -10.;
+        SafetyKatto_Ohno = -10.;
+        SafetyGroeneveld = -10.;
+        OCSStartAngle = 0.;
+        OCSEndAngle = 0.;
+        OCSCenterX = 0.;
+        OCSCenterY = 0.;
+        OCSCenterZ = 0.;
+        Nx = 0.;
+        Ny = 0.;
+        Nz = 0.;
+        Name = " ";
+    }
+};
+
+
+/*!
+* \class _branchInputs
+* \brief the data the calculation of a branch (dpBranch) depends on
+*
+* if none of them changed more than Base.SkipTol (relative) since the last calculation, the branch keeps dPLinear, dPConstant and the tube data
+*/
+class _branchInputs {
+public:
+    double g;                ///< flow in branch [kg/s]
+    double pIn;              ///< absolute pressure at inlet node [Pa]
+    double pOut;             ///< absolute pressure at outlet node [Pa]
+    double enthIn;           ///< spec. enthalpy at inlet [kJ/kg]
+    double gSteamIn;         ///< steam flow at inlet [kg/s]
+    double gTee[6];          ///< flows of the branches of a Tee at inlet and outlet node [kg/s], + leaving, - arriving the node
+    size_t NbNdIn;           ///< number of node at branch inlet (changes on reversal)
+    size_t mBrInNdIn;        ///< max index of branches in inlet node (changes if a branch is set to zero)
+    size_t mBrInNdOut;       ///< max index of branches in outlet node
+    int NoSections;          ///< sum of sections of all tubes
+
+    /// constructor
+    _branchInputs() {
+        g = 0.;
+        pIn = 0.;
+        pOut = 0.;
+        enthIn = 0.;
+        gSteamIn = 0.;
+        for (auto& igTee : gTee) igTee = 0.;
+        NbNdIn = MINUS1;
+        mBrInNdIn = MINUS1;
+        mBrInNdOut = MINUS1;
+        NoSections = 0;
+    }
+
+/**
+* \brief checks if the inputs differ less than the relative tolerance
+* \param [in] other inputs of last calculation
+* \param [in] tol relative tolerance
+* \return true if all values are within tolerance and the nodes are the same
+*/
+    bool isClose(const _branchInputs& other, double tol) const;
+};
 
 /*!
 * \class _branch 
@@ -1066,6 +1293,9 @@ public:
     double dPOut;            ///< pressure difference at branch outlet in Pa (by header or T-piece)
     double dPLinear;         ///< factor for pressure difference, characteristic curve (linear factor)
     double dPConstant;       ///< factor for pressure difference, characteristic curve (constant part)
+    bool useTangent;         ///< dPLinear is taken from the derivative of one calculation (tangent) instead of secant of 3 calculations
+    _branchInputs InputsLastCalc; ///< inputs of the last calculation by dpBranch
+    bool isLastCalcValid;    ///< InputsLastCalc is set
 
     ///constructor
     _branch() {
@@ -1099,6 +1329,8 @@ public:
         dPOut = 0.; // pressure difference at branch outlet in Pa (by header or T-piece)
         dPLinear = 0.; // factor for dyn. pressure difference (linear factor)
         dPConstant = 0.; // factor for dyn. pressure difference (constant part)
+        useTangent = true; // tangent is tried first, if not applicable the secant is used from then on
+        isLastCalcValid = false; // not yet calculated
         //			IsDirectionSet = false;
     }
     // functions
@@ -1111,13 +1343,19 @@ public:
 * 
 * the characteristic curve (pressure difference over flow) is approximated in vicinity of the flow in this step by a secant\n
 * the pressure difference (dPdyn and dPstat) is calculated 3 times to get 3 data points for the secant linear approximation  
+* for unheated single phase branches without flow dependent Tee resistance the slope is the derivative of the pressure difference
+* (forward mode automatic differentiation with _dual numbers), the pressure difference is calculated only once
+* \param [in] Model model the branch belongs to, activated for the calculation
 * \return int error code
 * \author Rainer_Jordan@<very, very warm>mail.com
 * #### Licence
 * Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
 * \date   September 2021
 */
-    int dpBranch();
+    int dpBranch(_circulationModel& Model);
+
+/// collects the actual inputs of dpBranch for this branch
+    _branchInputs Inputs() const;
 
 /*!
 * \file   KsiTee.cpp
@@ -1155,11 +1393,6 @@ public:
     int reverseDirection();
 };
 
-/*!
-\var vector <_branch> Branches;
-\brief vector holding all branches (of class _branch)
-*/
-EXTERN vector <_branch> Branches;
 
 /*!
 * \class _node
@@ -1204,6 +1437,11 @@ public:
     double enth;             ///< enthalpy of all arriving flows in node [kJ/kg]
     double gSumArrive;       ///< Sum of arriving flows [kg/s] used in enth and mesh
     double gSumLeave;        ///< Sum of leaving flows [kg/s] used in enth and mesh
+    SaturationState Sat;     ///< saturation properties at node pressure, kept while node pressure changes less than dpSatNode (enth)
+    double pMPaSat;          ///< absolute node pressure Sat was calculated for [MPa], < 0 if not yet calculated
+    double AngleT[3][2];     ///< angles between the tubes of a Tee [rad], set in isTee()
+    // pairs Straight[0]-Straight[1], Straight[0]-Off, Straight[1]-Off
+    // [0]: both tubes start (or both end) in this node, [1]: one tube starts, the other ends in this node
 
     /// constructor
     _node() {
@@ -1234,6 +1472,11 @@ public:
         //              For flow calculation only the differences between 2 Nodes are relevant
         pPrev = 0.; // nodal pressure from previous iteration step [Pa]
         enth = 0.; // enthalpy of all arriving flows in node [kJ/kg]
+        pMPaSat = -1.; // saturation properties not yet calculated
+        for (auto& iAngle : AngleT) {
+            iAngle[0] = 0.;
+            iAngle[1] = 0.;
+        }
     }
  
 /**
@@ -1253,12 +1496,148 @@ public:
 * \date   September 2021
 */
     bool isTee(_tube& firstTube, _tube& secondTube, _tube& thirdTube);
+
+/**
+* \brief spatial angle between 2 tubes of this Tee, same as first.Angle3d(second) but without calculation
+*
+* falls back to Angle3d if the tubes are not 2 different tubes of this Tee
+* \param [in] first reference to first tube
+* \param [in] second reference to second tube
+* \return spatial angle in radians
+*/
+    double AngleTee(const _tube& first, const _tube& second) const;
+};
+
+/*!
+* \class _nodeBranches
+* \brief branches of all nodes in one contiguous vector (compressed sparse row)
+*
+* the branches of node iNd are Br[Start[iNd]] .. Br[Start[iNd + 1] - 1] in the same order as in Nodes[iNd].NbBr\n
+* used by the path search in initFlow: one allocation instead of one vector per node\n
+* keeps the connection as set up in Mesh(), a branch set to zero flow in Step() is only taken out of Nodes[iNd].NbBr\n
+* the pattern of the equation system is set up from it (LES)
+*/
+class _nodeBranches {
+public:
+    stVector Start; ///< index of the first branch of each node in Br, size number of nodes + 1
+    stVector Br;    ///< branch numbers of all nodes
+
+    /// range of branch numbers of one node, usable in range-based for
+    struct Range {
+        const size_t* first; ///< first branch number
+        const size_t* last;  ///< behind last branch number
+        const size_t* begin() const { return first; }
+        const size_t* end() const { return last; }
+    };
+/*!
+* \brief (re)builds the vectors from Nodes[].NbBr
+*
+* has to be called again if nodes are renumbered
+*/
+    void build();
+    /// branch numbers of node iNd
+    Range of(size_t iNd) const { return { Br.data() + Start[iNd], Br.data() + Start[iNd + 1] }; }
+    /// reverses the order of branches of node iNd (as done for Nodes[iNd].NbBr)
+    void reverse(size_t iNd) { std::reverse(Br.begin() + Start[iNd], Br.begin() + Start[iNd + 1]); }
+};
+
+/*!
+* \class _meshTopology
+* \brief the mesh as determined by Mesh(): nodes, branches, direction of tubes and Tees
+*
+* filled by Mesh() and saved to the binary model file (saveModel), or read from it (readModel).\n
+* If it is valid Mesh() takes nodes and branches from here instead of determining them again.
+*/
+class _meshTopology {
+public:
+    bool isValid = false;          ///< complete, Mesh() uses it
+    vector<uint8_t> isReversed;    ///< for each tube: direction reversed to the direction of its branch
+    vector<stVector> PointTubes;   ///< for each point: the tubes connected in the order of the input (Points[].NbTb), the mesh was traced in this order
+    vector<_node> NodesMeshed;     ///< nodes with their branches as determined before the start values, Tee data as determined by determineTee()
+    vector<_branch> BranchesMeshed;///< branches with their nodes and tubes as determined before the start values
+    vector<double> beta;           ///< for each tube: angle to preceding tube or angle of bend [deg]
+    vector<USArrangement> UorS;    ///< for each tube: U or S arrangement
 };
+
 /*!
-\var vector <_node> Nodes;
-\brief vector holding all nodes (of class _node)
+* \class _circulationModel
+* \brief all data of one model: geometry, load case, state of the iteration and protocol
+*
+* the functions of the solver work on the model activated for the calling thread (ActiveModel, _activeModel)\n
+* they address its data by the names defined below (Base, Drum, Points, Tubes, Branches, Nodes, prot, ...),
+* thus several models can be calculated in one process at the same time, each in its own thread
 */
-EXTERN vector <_node> Nodes;
+class _circulationModel {
+public:
+    size_t mBr = 0;              ///< max index of branches (number of branches - 1)
+    size_t mTb = 0;              ///< max index of tubes (number of tubes - 1)
+    size_t mPt = 0;              ///< max index of Points (number of points - 1)
+    size_t mNd = 0;              ///< max index of nodes (number of nodes - 1)
+    string PathFile;             ///< full path to working directory as well as project name
+    vector<string> FileNames;    ///< all file names produced during calculation, to be called for deletion
+    _protocol prot;              ///< protocol file, used to trace data during calculation
+    _base Base{};                ///< some base values
+    _drum Drum{};                ///< data of the steam drum
+    vector<_point> Points;       ///< all points
+    vector<_tube> Tubes;         ///< all tubes
+    vector<_tubeOutput> TubesOutput; ///< output data of all tubes, same index as Tubes
+    vector<_branch> Branches;    ///< all branches
+    vector<_node> Nodes;         ///< all nodes
+    _nodeBranches NodeBranches;  ///< branches of all nodes (compressed sparse row), built in Mesh()
+    decltype(&_tube::dPTwoPhase) TwoPhaseKernel = nullptr; ///< instance of dPTwoPhaseMethod for Base.Method, set by SelectTwoPhaseMethod()
+    const size_t Id;             ///< unique number of the model, data a solver keeps between calls (f.i. LES) is only reused for the same model
+
+    /// constructor, empty model
+    _circulationModel() : Id(++Counter) {}
+    /// copy of data and state of another model, f.i. as start of a load case, the protocol is not copied (not open)
+    _circulationModel(const _circulationModel& Other) :
+        mBr(Other.mBr), mTb(Other.mTb), mPt(Other.mPt), mNd(Other.mNd), PathFile(Other.PathFile),
+        Base(Other.Base), Drum(Other.Drum), Points(Other.Points), Tubes(Other.Tubes), TubesOutput(Other.TubesOutput),
+        Branches(Other.Branches), Nodes(Other.Nodes), NodeBranches(Other.NodeBranches),
+        TwoPhaseKernel(Other.TwoPhaseKernel), Id(++Counter) {}
+    _circulationModel& operator=(const _circulationModel&) = delete;
+
+private:
+    static inline std::atomic<size_t> Counter{ 0 }; ///< number of models created
+};
+
+/*!
+\var _circulationModel* ActiveModel
+\brief model the solver works on in the calling thread, set by _activeModel
+*/
+inline thread_local _circulationModel* ActiveModel = nullptr;
+
+/*!
+* \class _activeModel
+* \brief activates a model for the calling thread as long as the object exists, the model activated before is restored afterwards
+*
+* f.i. set by main() for the main thread and by dpAllBranches() for the threads calculating branches
+*/
+class _activeModel {
+    _circulationModel* Previous; ///< model activated before
+public:
+    explicit _activeModel(_circulationModel& Model) : Previous(ActiveModel) { ActiveModel = &Model; }
+    ~_activeModel() { ActiveModel = Previous; }
+    _activeModel(const _activeModel&) = delete;
+    _activeModel& operator=(const _activeModel&) = delete;
+};
+
+/// data of the active model, by the names used throughout the solver
+#define mBr (ActiveModel->mBr)
+#define mTb (ActiveModel->mTb)
+#define mPt (ActiveModel->mPt)
+#define mNd (ActiveModel->mNd)
+#define PathFile (ActiveModel->PathFile)
+#define FileNames (ActiveModel->FileNames)
+#define prot (ActiveModel->prot)
+#define Base (ActiveModel->Base)
+#define Drum (ActiveModel->Drum)
+#define Points (ActiveModel->Points)
+#define Tubes (ActiveModel->Tubes)
+#define TubesOutput (ActiveModel->TubesOutput)
+#define Branches (ActiveModel->Branches)
+#define Nodes (ActiveModel->Nodes)
+#define NodeBranches (ActiveModel->NodeBranches)
 
 ///functions
 int main(int argc, char** argv);
@@ -1270,7 +1649,13 @@ int CalcPressureNodes(SparseMatrix<double>& S, /* System sparse matrix */
 
 extern int CalcEnthalpyNodes ( void );
 
-extern int Mesh ( );
+/*!
+* \brief sets up the mesh (nodes, branches) and the start values of the flow
+*
+* \param [in, out] Topology if valid, nodes and branches are taken from it (read from binary model file), otherwise they are determined and saved in it
+* \return int error code
+*/
+extern int Mesh(_meshTopology& Topology);
 
 /*****************************************************************//**
 * \file   StartResistance.cpp
@@ -1305,8 +1690,96 @@ extern void initFlow ();
 
 extern int readData ();
 
+/// sets Base.Control and the switches for the protocol output from the control number of the input
+extern void setControl(int Control);
+
+/// sets the saturation properties of the drum from Drum.pMPa, Drum.qSum is set to 0
+extern void setDrumProperties();
+
+/// sets Base.DowncomerLevel from highest and lowest point [m] and Drum.FlowSteam from Drum.qSum
+extern void setDowncomerLevel(double LevelHighestPoint, double LevelLowestPoint);
+
+/*****************************************************************//**
+* \brief the binary model file (*projectname*.wscb, see modelFile.h) is used if it is not older than the data file (*projectname*.dat)
+*
+* \return true if the model file is used instead of the data file
+ *********************************************************************/
+extern bool isModelFileCurrent();
+
+/*****************************************************************//**
+* \brief reads the input data from the binary model file (*projectname*.wscb) instead of the data file (readData)
+*
+* the file is mapped into memory, the records are copied to Points, Tubes etc. directly from there.
+* throws _wscError if the file is damaged or the data is wrong
+* \param [out] Topology the mesh, if it is in the file and valid for its input
+ *********************************************************************/
+extern void readModel(_meshTopology& Topology);
+
+/*****************************************************************//**
+* \brief the input data of the active model (after readData or readModel, before Mesh) as binary model file without mesh
+*
+* \return the content of the file
+ *********************************************************************/
+extern string modelInput();
+
+/*****************************************************************//**
+* \brief saves the binary model file (*projectname*.wscb): input data and the mesh
+*
+* \param [in] Input input data as given by modelInput() before Mesh()
+* \param [in] Topology mesh as determined by Mesh()
+ *********************************************************************/
+extern void saveModel(const string& Input, const _meshTopology& Topology);
+
 extern bool Step ( void );
 
+/*****************************************************************//**
+* \brief new flow in branches for Newton solver (no reversal of flow direction in this step)
+*
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+extern void NewtonUpdate();
+
+/// starts the step length control of the Newton solver again (after reversal of flow direction)
+extern void NewtonReset();
+
+/*****************************************************************//**
+* \brief new flow in branches by Anderson acceleration (no reversal of flow direction in this step)
+*
+* \return true if the accelerated flow is used, false: use the damped step (no history yet or a flow would change sign)
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+extern bool AndersonUpdate();
+
+/// deletes the history of Anderson acceleration (after reversal of flow direction)
+extern void AndersonReset();
+
+/*****************************************************************//**
+* \brief selects the instance of _tube::dPTwoPhaseMethod for Base.Method, called once after reading the input data
+*
+* throws _wscError if the calculation method is unknown
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+extern void SelectTwoPhaseMethod();
+
+/*****************************************************************//**
+* \brief calculation of pressure difference in all branches
+*
+* the branches are calculated in parallel (OpenMP), the protocol output is kept in the order of branches
+* \param skipZeroFlow true: branches with flow set to zero are not calculated
+* \param skipUnchanged true: branches with inputs changed less than Base.SkipTol keep their previous calculation, the share is written to protocol
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+* \date   September 2021
+ *********************************************************************/
+extern void dpAllBranches(bool skipZeroFlow, bool skipUnchanged);
+
 /*****************************************************************//**
 * \brief saves the flow in branches of this iteration step to file
 *
@@ -1320,6 +1793,56 @@ extern bool Step ( void );
  *********************************************************************/
 extern int saveFlow ();
 
+/*****************************************************************//**
+* \brief saves the state of the flow iteration to a binary checkpoint file
+*
+* node pressures and enthalpies, flow, flow direction, flow history and flags of branches, inlet state and section data of tubes\n
+* together with a hash of the model and of the load case
+* \param [in] FileName name of checkpoint file
+* @return int error code
+*
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+extern int saveCheckpoint(const string& FileName);
+
+/*****************************************************************//**
+* \brief reads the state of the flow iteration from a checkpoint file as start values
+*
+* the checkpoint is only used if the hash of the model (network and geometry) is the same,\n
+* a checkpoint of another load case (heat, drum pressure) is used as start values as well, that is noted in protocol
+* \param [in] FileName name of checkpoint file
+* @return int error code: 0 checkpoint used, 1 file not found, 2 wrong version, 3 other model
+*
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+extern int readCheckpoint(const string& FileName);
+
+/*****************************************************************//**
+* \brief iteration of the flow in branches of the active model until convergence (steps 5 to 14 of main program)
+*
+* \param [in] isInteractive true: iteration steps on console, question if the result is close enough at maximum number of iterations
+* @return true if the iteration converged
+ *********************************************************************/
+extern bool FlowIteration(bool isInteractive);
+
+/*****************************************************************//**
+* \brief calculates all load cases of the case table Base.SweepFile from the active (meshed) model
+*
+* the load cases are calculated in parallel threads, each from a copy of the model\n
+* a case starts from the converged state of the nearest case already calculated, only a few cases start from the flow of initFlow()\n
+* the results of all cases are written to one table (*projectname*_sweep.txt)
+* @return int exit code: 0 all cases converged, 2 otherwise
+*
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+extern int Sweep();
+
 /*****************************************************************//**
 * \brief calculates total energy dissipation
 *
@@ -193,15 +193,16 @@ extern _point OCS2WCS(double OCSCenterX, double OCSCenterY, double OCSCenterZ,
 					PointMidZ = (PtIn->zCoord + PtOut->zCoord) / 2.;
 				}
 				else { // bend
-					if (iTube.OCSEndAngle - iTube.OCSStartAngle < 0.) {
-						OCSMidAngle = (iTube.OCSStartAngle + iTube.OCSEndAngle + 360.) / 2.;
+					const _tubeOutput& iTubeOut = TubesOutput[iTube.Number];
+					if (iTubeOut.OCSEndAngle - iTubeOut.OCSStartAngle < 0.) {
+						OCSMidAngle = (iTubeOut.OCSStartAngle + iTubeOut.OCSEndAngle + 360.) / 2.;
 						if (OCSMidAngle >= 360.) OCSMidAngle -= 360.;
 					}
 					else {
-						OCSMidAngle = (iTube.OCSStartAngle + iTube.OCSEndAngle) / 2.;
+						OCSMidAngle = (iTubeOut.OCSStartAngle + iTubeOut.OCSEndAngle) / 2.;
 					}
-					_point WCSMidPoint = OCS2WCS(iTube.OCSCenterX, iTube.OCSCenterY, iTube.OCSCenterZ,
-							iTube.Nx, iTube.Ny, iTube.Nz, iTube.RadiusBend, OCSMidAngle);
+					_point WCSMidPoint = OCS2WCS(iTubeOut.OCSCenterX, iTubeOut.OCSCenterY, iTubeOut.OCSCenterZ,
+							iTubeOut.Nx, iTubeOut.Ny, iTubeOut.Nz, iTube.RadiusBend, OCSMidAngle);
 					PointMidX = WCSMidPoint.xCoord;
 					PointMidY = WCSMidPoint.yCoord;
 					PointMidZ = WCSMidPoint.zCoord;
@@ -221,12 +222,13 @@ extern _point OCS2WCS(double OCSCenterX, double OCSCenterY, double OCSCenterZ,
 	case ShowMode::SafetyFactor:
 		for (const auto& iTube : Tubes) {
 			if (iTube.Dia < MinDrumDiameter) {
+				const _tubeOutput& iTubeOut = TubesOutput[iTube.Number];
 				content = to_string(iTube.Number);
-				LayerName = "Tb " + content + " " + to_string(iTube.SafetyFactor);
+				LayerName = "Tb " + content + " " + to_string(iTubeOut.SafetyFactor);
 	         color = 0;
 	         if (iTube.q > 0.) {
-					if (iTube.SafetyFactor < 1.) color = 1;
-					else if (iTube.SafetyFactor < 1.2) color = 2;
+					if (iTubeOut.SafetyFactor < 1.) color = 1;
+					else if (iTubeOut.SafetyFactor < 1.2) color = 2;
 					else color = 3;
 				}
 				//            prot << "\n" << LayerName << " color " << color;
@@ -69,20 +69,21 @@ int DXFWriteTube(ostream& outData, const _tube& iTube,  unsigned long long& hand
 		PointMidZ = (PtIn->zCoord + PtOut->zCoord) / 2.;
 	}
 	else { //bend
+		const _tubeOutput& iTubeOut = TubesOutput[iTube.Number];
 		error = DXFWriteArc(outData, handle, LayerName, color,
-			iTube.OCSCenterX, iTube.OCSCenterY, iTube.OCSCenterZ,
-			iTube.RadiusBend*1e3, iTube.Nx, iTube.Ny, iTube.Nz,
-			iTube.OCSStartAngle, iTube.OCSEndAngle);
+			iTubeOut.OCSCenterX, iTubeOut.OCSCenterY, iTubeOut.OCSCenterZ,
+			iTube.RadiusBend*1e3, iTubeOut.Nx, iTubeOut.Ny, iTubeOut.Nz,
+			iTubeOut.OCSStartAngle, iTubeOut.OCSEndAngle);
 		if (error) return error;
-		if (iTube.OCSEndAngle - iTube.OCSStartAngle < 0.) {
-			OCSMidAngle = (iTube.OCSStartAngle + iTube.OCSEndAngle + 360.) / 2.;
+		if (iTubeOut.OCSEndAngle - iTubeOut.OCSStartAngle < 0.) {
+			OCSMidAngle = (iTubeOut.OCSStartAngle + iTubeOut.OCSEndAngle + 360.) / 2.;
 			if (OCSMidAngle > 360.) OCSMidAngle -= 360.;
 		}
 		else {
-			OCSMidAngle = (iTube.OCSStartAngle + iTube.OCSEndAngle) / 2.;
+			OCSMidAngle = (iTubeOut.OCSStartAngle + iTubeOut.OCSEndAngle) / 2.;
 		}
-		_point WCSMidPoint = OCS2WCS(iTube.OCSCenterX, iTube.OCSCenterY, iTube.OCSCenterZ,
-			iTube.Nx, iTube.Ny, iTube.Nz, iTube.RadiusBend*1e3, OCSMidAngle);
+		_point WCSMidPoint = OCS2WCS(iTubeOut.OCSCenterX, iTubeOut.OCSCenterY, iTubeOut.OCSCenterZ,
+			iTubeOut.Nx, iTubeOut.Ny, iTubeOut.Nz, iTube.RadiusBend*1e3, OCSMidAngle);
 		PointMidX = WCSMidPoint.xCoord;
 		PointMidY = WCSMidPoint.yCoord;
 		PointMidZ = WCSMidPoint.zCoord;
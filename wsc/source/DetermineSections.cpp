@@ -13,9 +13,7 @@ void _tube::DetermineNoSections(double g) {
 	 *
 	 */
 	NoSections = 1;
-	if ((RadiusBend < 1e-3 && Length / Dia > 2.) ||
-		(RadiusBend > 1e-3 && RadiusBend / Dia > 5.) 
-		) {
+	if (isSectioned()) {
 		//      if (Number == 363) {
 		//         prot << "\n determine Length " << Length << " dia " << Dia;
 		//         prot << "\n q " << q;
@@ -38,11 +36,11 @@ void _tube::DetermineNoSections(double g) {
 			//         }
 						/// 4.) heated tubes: additional limitation of change of void fraction (for simplicity homogeneous at inlet condition), should not be higher than 5% 
 			double pMPaIn = pPaIn * 1e-6;
-			double tSat = H2O::satTemp(pMPaIn);
-			double rhoSSat = 1. / H2O::specVol(tSat, pMPaIn, STEAM);
-			double rhoWSat = 1. / H2O::specVol(tSat, pMPaIn, WATER);
-			double enthWSat = H2O::enth(tSat, pMPaIn, WATER);
-			double enthSSat = H2O::enth(tSat, pMPaIn, STEAM);
+			SaturationState Sat = H2O::satState(pMPaIn);
+			double rhoSSat = 1. / Sat.volS;
+			double rhoWSat = 1. / Sat.volW;
+			double enthWSat = Sat.enthW;
+			double enthSSat = Sat.enthS;
 			double xTbIn = (EnthIn - enthWSat) / (enthSSat - enthWSat);
 			double VoidFractIn;
 			if (xTbIn < 0.) {
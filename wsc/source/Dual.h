@@ -0,0 +1,70 @@
+/*! \file Dual.h
+   \brief dual numbers for forward mode automatic differentiation
+
+   A dual number carries a value and its derivative with respect to one independent variable.\n
+   All arithmetic and the elementary functions used in the friction correlations propagate the derivative by the chain rule,\n
+   thus a correlation written for a template type T evaluated with _dual returns the value and the exact derivative in one pass.
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+*/
+#ifndef _DUAL_H
+#define _DUAL_H
+#include <cmath>
+#include <ostream>
+
+/*!
+* \class _dual
+* \brief value and derivative with respect to one independent variable
+*/
+class _dual {
+public:
+	double val; ///< value
+	double der; ///< derivative with respect to the independent variable
+
+	/// constructor, a plain number has derivative 0
+	_dual(double value = 0., double derivative = 0.) : val(value), der(derivative) {}
+
+	_dual& operator+=(const _dual& b) { val += b.val; der += b.der; return *this; }
+	_dual& operator-=(const _dual& b) { val -= b.val; der -= b.der; return *this; }
+	_dual& operator*=(const _dual& b) { der = der * b.val + val * b.der; val *= b.val; return *this; }
+	_dual& operator/=(const _dual& b) { der = (der * b.val - val * b.der) / (b.val * b.val); val /= b.val; return *this; }
+};
+
+inline _dual operator-(const _dual& a) { return _dual(-a.val, -a.der); }
+inline _dual operator+(_dual a, const _dual& b) { return a += b; }
+inline _dual operator-(_dual a, const _dual& b) { return a -= b; }
+inline _dual operator*(_dual a, const _dual& b) { return a *= b; }
+inline _dual operator/(_dual a, const _dual& b) { return a /= b; }
+inline _dual operator+(_dual a, double b) { a.val += b; return a; }
+inline _dual operator+(double a, _dual b) { b.val += a; return b; }
+inline _dual operator-(_dual a, double b) { a.val -= b; return a; }
+inline _dual operator-(double a, const _dual& b) { return _dual(a - b.val, -b.der); }
+inline _dual operator*(const _dual& a, double b) { return _dual(a.val * b, a.der * b); }
+inline _dual operator*(double a, const _dual& b) { return _dual(a * b.val, a * b.der); }
+inline _dual operator/(const _dual& a, double b) { return _dual(a.val / b, a.der / b); }
+inline _dual operator/(double a, const _dual& b) { return _dual(a / b.val, -a * b.der / (b.val * b.val)); }
+
+/// comparisons only use the value, the branches of a correlation are chosen as for double
+inline bool operator<(const _dual& a, double b) { return a.val < b; }
+inline bool operator>(const _dual& a, double b) { return a.val > b; }
+inline bool operator<=(const _dual& a, double b) { return a.val <= b; }
+inline bool operator>=(const _dual& a, double b) { return a.val >= b; }
+
+inline _dual sqrt(const _dual& a) { double s = std::sqrt(a.val); return _dual(s, a.der / (2. * s)); }
+inline _dual exp(const _dual& a) { double e = std::exp(a.val); return _dual(e, a.der * e); }
+inline _dual log(const _dual& a) { return _dual(std::log(a.val), a.der / a.val); }
+inline _dual tanh(const _dual& a) { double t = std::tanh(a.val); return _dual(t, a.der * (1. - t * t)); }
+inline _dual fabs(const _dual& a) { return a.val < 0. ? -a : a; }
+inline _dual pow(const _dual& a, double b) {
+	double p = std::pow(a.val, b - 1.);
+	return _dual(p * a.val, a.der * b * p);
+}
+/// the maximum/minimum takes value and derivative of the selected argument
+inline _dual fmax(const _dual& a, double b) { return a.val >= b ? a : _dual(b); }
+inline _dual fmin(const _dual& a, double b) { return a.val <= b ? a : _dual(b); }
+
+/// protocol output shows the value only
+inline std::ostream& operator<<(std::ostream& os, const _dual& a) { return os << a.val; }
+
+#endif
@@ -10,7 +10,121 @@
 #undef MAINFUNCTION
 #include "CommonHeader.h"
 
+#include <algorithm>
+
 const int MaxIterH = 400; ///< max number of iterations
+const double dpSatNode = 1e-5; ///< saturation properties of a node are kept while node pressure changes less than this [MPa]
+
+/**
+* \brief group of nodes for enthalpy calculation
+*
+* the nodes of an acyclic group need only one pass in the given order, a cyclic group (strongly connected component) is iterated
+*/
+struct EnthalpyBlock {
+	stVector NbNd; ///< node numbers in calculation order
+	bool isCyclic; ///< nodes depend on each other, iteration needed
+};
+
+/**
+* \brief order of nodes for enthalpy calculation according to flow direction
+*
+* The enthalpy of a node only depends on the nodes upstream (start nodes of arriving branches).\n
+* Normally the network without drum is acyclic: the topological order (Kahn) gives all node enthalpies in one pass.\n
+* If there are loops of flow, the strongly connected components (Tarjan) are ordered topologically and only the nodes of each loop are iterated.\n
+* Drum is the source of all flows and is not part of the order.
+* \param [out] Blocks groups of nodes in calculation order
+*/
+static void EnthalpyOrder(vector<EnthalpyBlock>& Blocks) {
+	size_t NoNd = Nodes.size();
+	vector<size_t> InDegree(NoNd, 0);
+	stVector Order;
+	Blocks.clear();
+	Order.reserve(NoNd);
+	for (const auto& iNode : Nodes) {
+		if (iNode.Number == DRUM) continue;
+		for (const auto& Leave : iNode.NbBrLeave) {
+			if (Branches[Leave].NbNdOut != DRUM) InDegree[Branches[Leave].NbNdOut]++;
+		}
+	}
+	/**
+	 * -# Kahn: nodes without arriving branches from other nodes than drum are first, then the nodes whose upstream nodes are all done
+	 */
+	for (size_t iNd = 1; iNd < NoNd; ++iNd) {
+		if (InDegree[iNd] == 0) Order.push_back(iNd);
+	}
+	for (size_t i = 0; i < Order.size(); ++i) {
+		for (const auto& Leave : Nodes[Order[i]].NbBrLeave) {
+			size_t iNdOut = Branches[Leave].NbNdOut;
+			if (iNdOut != DRUM && --InDegree[iNdOut] == 0) Order.push_back(iNdOut);
+		}
+	}
+	if (Order.size() == NoNd - 1) {
+		Blocks.push_back({ Order, false });
+		return;
+	}
+	/**
+	 * -# Tarjan (without recursion): strongly connected components are found in reverse topological order
+	 */
+	const size_t UNVISITED = MINUS1;
+	vector<size_t> Index(NoNd, UNVISITED), LowLink(NoNd, 0), NextLeave(NoNd, 0);
+	vector<bool> onStack(NoNd, false);
+	stVector Stack, CallStack;
+	size_t Counter = 0;
+	for (size_t iRoot = 1; iRoot < NoNd; ++iRoot) {
+		if (Index[iRoot] != UNVISITED) continue;
+		CallStack.push_back(iRoot);
+		while (!CallStack.empty()) {
+			size_t iNd = CallStack.back();
+			if (Index[iNd] == UNVISITED) {
+				Index[iNd] = LowLink[iNd] = Counter++;
+				Stack.push_back(iNd);
+				onStack[iNd] = true;
+			}
+			bool isDescending = false;
+			while (NextLeave[iNd] < Nodes[iNd].NbBrLeave.size()) {
+				size_t iNdOut = Branches[Nodes[iNd].NbBrLeave[NextLeave[iNd]++]].NbNdOut;
+				if (iNdOut == DRUM) continue;
+				if (Index[iNdOut] == UNVISITED) {
+					CallStack.push_back(iNdOut);
+					isDescending = true;
+					break;
+				}
+				if (onStack[iNdOut]) LowLink[iNd] = min(LowLink[iNd], Index[iNdOut]);
+			}
+			if (isDescending) continue;
+			CallStack.pop_back();
+			if (!CallStack.empty()) LowLink[CallStack.back()] = min(LowLink[CallStack.back()], LowLink[iNd]);
+			if (LowLink[iNd] == Index[iNd]) {
+				EnthalpyBlock Component = { {}, false };
+				size_t iNdSCC;
+				do {
+					iNdSCC = Stack.back();
+					Stack.pop_back();
+					onStack[iNdSCC] = false;
+					Component.NbNd.push_back(iNdSCC);
+				} while (iNdSCC != iNd);
+				std::sort(Component.NbNd.begin(), Component.NbNd.end());
+				Component.isCyclic = Component.NbNd.size() > 1;
+				if (!Component.isCyclic) { // a branch starting and ending in the same node is a loop as well
+					for (const auto& Leave : Nodes[iNd].NbBrLeave) {
+						if (Branches[Leave].NbNdOut == iNd) Component.isCyclic = true;
+					}
+				}
+				Blocks.push_back(Component);
+			}
+		}
+	}
+	std::reverse(Blocks.begin(), Blocks.end());
+	if (Base.showEnth) {
+		prot << "\n enthalpy: " << Blocks.size() << " groups of nodes, loops of flow in:";
+		for (const auto& Block : Blocks) {
+			if (Block.isCyclic) {
+				prot << "\n ";
+				for (const auto& iNd : Block.NbNd) prot << " " << iNd;
+			}
+		}
+	}
+}
 
 #if 0
 As equal distribution to all leaving branches is standard case
@@ -53,6 +167,7 @@ int CalcEnthalpyNodes(void) {
 		pNd;
 	double SeparationFactor = 1.; ///< it is the part of steam flow in node that goes in the branch with less steam. A factor of 1 means equal inlet enthalpy in all branches
 	int iterh;
+	static thread_local vector<EnthalpyBlock> Blocks;
 
 	//prot << "\n start enth drum enthalpy " << Drum.enthW << "\n";
 /**
@@ -100,15 +215,18 @@ int CalcEnthalpyNodes(void) {
 	/**
 	 *-# the enthalpy in the node depends on the enthalpies of the nodes connected to this node\n
 	 *    certainly only the incoming (arriving) branches and their start nodes\n
-	 *    as each node depends on most other nodes there is an iteration loop until the differences are too small
+	 *    the nodes are calculated in flow direction (topological order), each node after all its upstream nodes\n
+	 *    only nodes in loops of flow depend on each other, there is an iteration loop for these nodes until the differences are too small
 	 */
-	for (iterh = 1; iterh <= MaxIterH; ++iterh) {
-		double diffSum = 0.;
-		/**
-		*-# Loop over all nodes except drum
-		*/
-		for (_node& iNode : Nodes) {
-			if (iNode.Number > 0) {
+	EnthalpyOrder(Blocks);
+	for (const auto& Block : Blocks) {
+		for (iterh = 1; iterh <= MaxIterH; ++iterh) {
+			double diffSum = 0.;
+			/**
+			*-# Loop over all nodes of this group (drum is not included)
+			*/
+			for (const auto& iNd : Block.NbNd) {
+				_node& iNode = Nodes[iNd];
 				/**
 				*	-# determine enthalpy and steam in node by summing up outlet enthalpy * flow for all arriving branches\n
 				*		and divide by sum of incoming flows
@@ -136,9 +254,17 @@ int CalcEnthalpyNodes(void) {
 				 * if yes calculate steam flow in node
 				 */
 				pNd = iNode.pNode / 1e6 + Drum.pMPa;
-				tSatNd = H2O::satTemp(pNd);
-				enthWSatNd = H2O::enth(tSatNd, pNd, WATER);
-				enthEvapNd = H2O::enth(tSatNd, pNd, STEAM) - enthWSatNd;
+				/**
+				 * -# the saturation properties are kept from previous call while the node pressure changes less than dpSatNode
+				 */
+				if (fabs(pNd - iNode.pMPaSat) > dpSatNode) {
+					iNode.Sat = H2O::satState(pNd);
+					iNode.pMPaSat = pNd;
+				}
+				const SaturationState& SatNd = iNode.Sat;
+				tSatNd = SatNd.tSat;
+				enthWSatNd = SatNd.enthW;
+				enthEvapNd = SatNd.enthS - enthWSatNd;
 				if (iNode.enth > enthWSatNd) {
 					iNode.gSteam = (iNode.enth - enthWSatNd) / enthEvapNd * iNode.gSumArrive;
 				}
@@ -372,27 +498,28 @@ int CalcEnthalpyNodes(void) {
 				if (Base.showEnth) {
 					prot << "\n\n";
 				}
-			}
-		} // end nodes-loop
+			} // end nodes-loop
 /**
- * -# end of loop over all nodes
- * -# check for condition to break main iteration loop\n
+ * -# end of loop over all nodes of this group
+ * -# without loops of flow one pass is sufficient
+ * -# check for condition to break iteration loop of nodes in loops of flow\n
  * sum of all enthalpy differences between this step and previous step should be less than 1 kJ/kg
- * -# end of main iteration loop
+ * -# end of iteration loop
  */
-		if (Base.showEnth) {
-			prot << "\n iterh = " << iterh << " diffSum " << diffSum;
-		}
-		if (diffSum < 1.) break;
-		if (iterh >= MaxIterH - 1) {
-			Base.showEnth = true;
-			if (iterh == MaxIterH) {
-				cout << "\n maximum number of Iterations in enth exceeded" << endl;
-				prot << "\n maximum number of Iterations in enth exceeded" << endl;
-				return 1;
+			if (Base.showEnth) {
+				prot << "\n iterh = " << iterh << " diffSum " << diffSum;
 			}
-		}
-	} // end iterh-loop
+			if (!Block.isCyclic || diffSum < 1.) break;
+			if (iterh >= MaxIterH - 1) {
+				Base.showEnth = true;
+				if (iterh == MaxIterH) {
+					cout << "\n maximum number of Iterations in enth exceeded" << endl;
+					prot << "\n maximum number of Iterations in enth exceeded" << endl;
+					return 1;
+				}
+			}
+		} // end iterh-loop
+	} // end groups-loop
 
 	if (Base.showEnth) {
 		prot << "\n    *********************";
@@ -5,16 +5,15 @@
 
 #include "CommonHeader.h"
 
-double _tube::ksiBend(double Reynolds, double AngleDeg) {
+template <typename T> T _tube::ksiBend(T Reynolds, double AngleDeg) {
 	/* Local variables */
-	int j;
-	double  us[7], ksiBend = 0., d__2;
+	double d__2;
+	T ksiBend = 0.;
 	double eta = 0.;
-	double fh = 2.;
+	T fh = 2.;
 	double fm = 1.;
 	double fa = 1.;
-	double fr = 1.;
-	double RelRough = Base.Rough / Dia;
+	T fr = 1.;
 	double RelRadius = RadiusBend / Dia;
 	/*!
 	 * Different calculation is done whether it is a smooth or sharp edged bend\n
@@ -81,49 +80,17 @@ double _tube::ksiBend(double Reynolds, double AngleDeg) {
 		 *     "S" or "U" arrangement                     */
 		 /*     ------------------------------------------ */
 		if (UorS != USArrangement::No) {
-			double dist = Length - 2. * RadiusBend;
-			if (dist < 1e-3) {
-				if (UorS == USArrangement::S) {
-					eta = 1.1964706; // is  ‬ 1.0982353 *2. -1.;
-				}
-				else {
-					eta = 0.21844428; // is  .60922214* 2.-1.;
-				}
-			}
-			else {
-				if (UorS == USArrangement::S) {
-					us[0] = 1.0982353;
-					us[1] = -.20151263;
-					us[2] = .05792232;
-					us[3] = -.0080823559;
-					us[4] = 6.0783983e-4;
-					us[5] = -2.3790387e-5;
-					us[6] = 3.8269694e-6;
-				}
-				else {
-					us[0] = .60922214;
-					us[1] = .060370803;
-					us[2] = -.0072293581;
-					us[3] = 7.8684409e-4;
-					us[4] = -8.0123244e-5;
-					us[5] = 4.8920378e-6;
-					us[6] = -1.1609907e-7;
-				}
-				for (j = 0; j < 7; ++j) {
-					eta += us[j] * pow(dist / Dia, j);
-				}
-
-				//! For smooth bends the arrangement of consecutive bends in U- or S-arrangement is taken into account.\n 
-				//! a correction factor "eta" is calculated\n 
-				//! for both bends the total ksiBend = 2 * eta * ksiBend(single)\n
-				//! eta is only applied to the first bend,\n
-				//! assuming ~ equal ksiBend for both bends the first bend takes full advantage\n 
-				//! ksiBend = ksiBend *(2*eta - 1) and the second uses eta = 1\n
-				if (eta > 0.5) {
-					ksiBend *= (2. * eta - 1.);
-					if (Base.showDPTubeDetail) {
-						prot << "\neta < 0  Length " << Length << "  Dia " << Dia << " UorS ";
-					}
+			eta = etaBendUS; // setConstants()
+			//! For smooth bends the arrangement of consecutive bends in U- or S-arrangement is taken into account.\n 
+			//! a correction factor "eta" is calculated\n 
+			//! for both bends the total ksiBend = 2 * eta * ksiBend(single)\n
+			//! eta is only applied to the first bend,\n
+			//! assuming ~ equal ksiBend for both bends the first bend takes full advantage\n 
+			//! ksiBend = ksiBend *(2*eta - 1) and the second uses eta = 1\n
+			if (Length - 2. * RadiusBend >= 1e-3 && eta > 0.5) {
+				ksiBend *= (2. * eta - 1.);
+				if (Base.showDPTubeDetail) {
+					prot << "\neta < 0  Length " << Length << "  Dia " << Dia << " UorS ";
 				}
 			}
 		}
@@ -167,3 +134,5 @@ double _tube::ksiBend(double Reynolds, double AngleDeg) {
 	}
 	return ksiBend;
 } /* Bend */
+template double _tube::ksiBend<double>(double Reynolds, double AngleDeg);
+template _dual _tube::ksiBend<_dual>(_dual Reynolds, double AngleDeg);
@@ -4,36 +4,40 @@
 
 // Brandt, F., Dampferzeuger: Kesselsysteme, Energiebilanz, Stroemungstechnik. FDBR Fachbuchreihe Band 3, Vulkan-Verlag Essen, 1992  
 
-double _tube::ksiOrifice(double LengthOrifice, double visc) {
-	double ReOrifice, m1, m2, tau, eps, ksi0, ksiphi;
-	double DiaOrifice, zeta, ret_val;
+template <typename T> T _tube::ksiOrifice(double LengthOrifice, double visc, T MassVelocity) {
+	double m2, tau;
+	double DiaOrifice;
+	double ksiPhiGeo; // Reynolds independent part of ksiphi
+	T ReOrifice, eps, ksi0, ksiphi, zeta, ret_val;
 
 	/// If the length of orifice > 0 we have inlet orifice (typical smaller hole in header,\n
 	/// length of orifice is header wall thickness)
 	if (LengthOrifice > 1e-3) {
+		/// (m1 = 0: 0.5 (1 - m1) = 0.5, exp(-18.34 m1^3.5) = 1)
 		DiaOrifice = DiaOrificeIn;
-		m1 = 0.;
 		m2 = DiaOrifice / Dia;
 		tau = 0.5 * (1. - tanh((LengthOrifice / DiaOrifice - 0.657) * 2.264));
+		ksi0 = 0.5 + (1. - m2) * (1. - m2) + tau * (1. - m2);
+		ksiPhiGeo = 0.39;
 	}
 	else {
+		/// outlet orifice (m1 = m2): the geometric parts are set by setConstants()
 		DiaOrifice = DiaOrificeOut;
-		m1 = DiaOrifice / Dia;
-		m2 = m1;
-		tau = 1.35;
+		m2 = DiaOrifice / Dia;
+		ksi0 = ksi0OrificeOut;
+		ksiPhiGeo = ksiPhiOrificeOut;
 	}
 
-	ksi0 = 0.5 * (1. - m1) + (1. - m2) * (1. - m2) + tau * sqrt(1. - m1) * (1. - m2);
-
-	ReOrifice = MassVel / (m2 * m2) * DiaOrifice / visc;
+	ReOrifice = MassVelocity / (m2 * m2) * DiaOrifice / visc;
 	zeta = FrictFact(ReOrifice, Base.Rough / DiaOrifice);
 
 	if (ReOrifice < 1e5) {
-		ksiphi = 0.39 * exp(-18.34 * pow(m1, 3.5)) * exp(-1.078 * (log(ReOrifice) - 3.));
+		ksiphi = ksiPhiGeo * exp(-1.078 * (log(ReOrifice) - 3.));
 		eps = 0.26 * tanh(1.04 * (log(ReOrifice) - 4.)) + 0.74;
 		ksi0 = ksiphi + eps * ksi0;
 	}
 	ret_val = (ksi0 + zeta * fabs(LengthOrifice) / DiaOrifice) * (1. / (m2 * m2));
 	return ret_val;
 }
-
+template double _tube::ksiOrifice<double>(double LengthOrifice, double visc, double MassVelocity);
+template _dual _tube::ksiOrifice<_dual>(double LengthOrifice, double visc, _dual MassVelocity);
@@ -18,6 +18,88 @@
 //#include "stdafx.h"
 #undef MAINFUNCTION
 #include "CommonHeader.h"
+#include <algorithm>
+
+/**
+ * \struct LESBranchSlots
+ * \brief places in the equation system where one branch adds its values
+ *
+ * NbNdA and NbNdB are inlet and outlet node when the pattern was set up, after a reversal of the branch
+ * only the sign of the right hand side changes\n
+ * the slots are indices in the value array of the compressed system matrix, MINUS1 if the node is the drum
+ */
+struct LESBranchSlots {
+	size_t NbBr = MINUS1;  ///< number of branch
+	size_t NbNdA = MINUS1; ///< node A (inlet node when the pattern was set up)
+	size_t NbNdB = MINUS1; ///< node B (outlet node when the pattern was set up)
+	size_t AA = MINUS1;    ///< slot of diagonal element of node A
+	size_t BB = MINUS1;    ///< slot of diagonal element of node B
+	size_t AB = MINUS1;    ///< slot of row A, column B
+	size_t BA = MINUS1;    ///< slot of row B, column A
+};
+
+/**
+ * \brief index of an element of compressed system matrix in its value array
+ *
+ * \param S reference to system sparse matrix (compressed, column major)
+ * \param iNd row (node number, drum excluded)
+ * \param jNd column (node number, drum excluded)
+ * \return size_t index in value array, MINUS1 if one node is the drum
+ */
+size_t LESSlot(const SparseMatrix<double>& S, size_t iNd, size_t jNd) {
+	if (iNd == DRUM || jNd == DRUM) return MINUS1;
+	long long row = static_cast<long long> (iNd - 1ULL);
+	long long col = static_cast<long long> (jNd - 1ULL);
+	const auto* Inner = S.innerIndexPtr();
+	auto first = Inner + S.outerIndexPtr()[col];
+	auto last = Inner + S.outerIndexPtr()[col + 1];
+	auto it = std::lower_bound(first, last, row);
+	return static_cast<size_t> (it - Inner);
+}
+
+/**
+ * \brief sets up the pattern of the system matrix and the assembly plan
+ *
+ * all entries that can be set by a branch between two nodes are created (value 0.)\n
+ * the pattern only depends on the branches connected to the nodes as set up in Mesh() (NodeBranches), not on flow or flow direction\n
+ * a branch set to zero flow keeps its entries, it just adds nothing (dPLinear = 0), thus the pattern is the same for the whole run\n
+ * for each branch the places of its values in the matrix are stored in Plan, the assembly is then one pass over the branches
+ * \param S reference to system sparse matrix
+ * \param Plan reference to vector of branch slots
+ */
+void LESPattern(SparseMatrix<double>& S, vector<LESBranchSlots>& Plan) {
+	size_t jNd;
+	vector<Triplet<double>> Entries;
+	for (size_t iNd = 1; iNd <= mNd; ++iNd) {
+		long long iNdLL = static_cast<long long> (iNd - 1ULL);
+		Entries.push_back(Triplet<double>(iNdLL, iNdLL, 0.));
+		for (const auto& iBr : NodeBranches.of(iNd)) {
+			jNd = Branches[iBr].NbNdOut;
+			if (jNd == iNd) jNd = Branches[iBr].NbNdIn;
+			if (jNd > 0) {
+				Entries.push_back(Triplet<double>(iNdLL, static_cast<long long> (jNd - 1ULL), 0.));
+			}
+		}
+	}
+	S.setZero();
+	S.setFromTriplets(Entries.begin(), Entries.end()); // double entries (parallel branches) are summed up
+	S.makeCompressed();
+
+	Plan.clear();
+	Plan.reserve(mBr + 1);
+	for (const auto& iBranch : Branches) {
+		LESBranchSlots Slots;
+		Slots.NbBr = iBranch.Number;
+		Slots.NbNdA = iBranch.NbNdIn;
+		Slots.NbNdB = iBranch.NbNdOut;
+		Slots.AA = LESSlot(S, Slots.NbNdA, Slots.NbNdA);
+		Slots.BB = LESSlot(S, Slots.NbNdB, Slots.NbNdB);
+		Slots.AB = LESSlot(S, Slots.NbNdA, Slots.NbNdB);
+		Slots.BA = LESSlot(S, Slots.NbNdB, Slots.NbNdA);
+		Plan.push_back(Slots);
+	}
+	return;
+}
 
 bool LES(SparseMatrix<double>& S, /* System matrix as n*? sized vector.*/
 	VectorXd& B, /* right hand side vector............*/
@@ -25,52 +107,54 @@ bool LES(SparseMatrix<double>& S, /* System matrix as n*? sized vector.*/
 ) // true, if successful
 {
 	/* Local variables */
-	double direction;
-	size_t iNd, jNd;
+	size_t iNd;
+	/**
+	 * the solver is kept between the iteration steps\n
+	 * the symbolic analysis (ordering, elimination tree) is only done if the pattern of the matrix changed (Base.TopologyVersion),
+	 * i.e. in the first call after Mesh()\n
+	 * neither a reversal of flow direction nor a branch set to zero flow changes the pattern\n
+	 * the solver is kept per thread and is only reused for the same model
+	 */
+	static thread_local SimplicialLDLT<SparseMatrix<double>> solver;
+	static thread_local vector<LESBranchSlots> Plan;
+	static thread_local size_t PatternVersion = MINUS1;
+	static thread_local size_t PatternModel = 0;
+
+	if (PatternVersion != Base.TopologyVersion || PatternModel != ActiveModel->Id) {
+		LESPattern(S, Plan);
+		solver.analyzePattern(S);
+		PatternVersion = Base.TopologyVersion;
+		PatternModel = ActiveModel->Id;
+	}
 	//  prot << "\n in LES";
 	  /**
 		* setting of equation system.\n
 		* Based on mass balance in all nodes\n
 		* As steam drum pressure is fixed, the steam drum is not included\n
-		* the size of the square matrix is "number of nodes" - 1
+		* the size of the square matrix is "number of nodes" - 1\n
+		* each branch adds its values directly to the places stored in Plan
 		*/
-	S.setZero();
-	for (iNd = 1; iNd <= mNd; ++iNd) {
-		bool isSeti = false;
-		bool isSetj = false;
-		// index for Eigen has to be long long, iNd is unsigned long long 
-		// in the cast the -1 is also applied for offset to exclude steam drum 
-		long long iNdLL = static_cast<long long> (iNd - 1ULL);
-		B.coeffRef(iNdLL) = 0.;
-		for (const auto& iBr : Nodes[iNd].NbBr) {
-			_branch iBranch = Branches[iBr];
-			if (fabs(iBranch.dPLinear) > 1e-6) {
-				jNd = iBranch.NbNdOut;
-				direction = 1.;
-				if (jNd == iNd) {
-					jNd = iBranch.NbNdIn;
-					direction = -1.;
-				}
-				if (isSeti) {
-					S.coeffRef(iNdLL, iNdLL) += 1. / iBranch.dPLinear;
-				}
-				else {
-					S.insert(iNdLL, iNdLL) = 1. / iBranch.dPLinear;
-					isSeti = true;
-				}
-				//            A[iNd-1][iNd-1] += 1./Branch[iBr].dynLin;
-				if (jNd > 0) {
-					long long jNdLL = static_cast<long long> (jNd - 1ULL);
-					if (isSetj) {
-						S.coeffRef(iNdLL, jNdLL) -= 1. / iBranch.dPLinear;
-					}
-					else {
-						S.insert(iNdLL, jNdLL) = -1. / iBranch.dPLinear;
-						isSetj = true;
-					}
-					//               A[iNd-1][jNd-1]-=1./Branch[iBr].dynLin;
-				}
-				B.coeffRef(iNdLL) += direction * iBranch.dPConstant / iBranch.dPLinear;
+	S.coeffs().setZero();
+	B.setZero();
+	double* Values = S.valuePtr();
+	for (const auto& Slots : Plan) {
+		const _branch& iBranch = Branches[Slots.NbBr];
+		if (fabs(iBranch.dPLinear) > 1e-6) {
+			double conductance = 1. / iBranch.dPLinear;
+			// flow from A to B is positive, after a reversal of the branch the constant part changes sign 
+			double rhs = iBranch.dPConstant * conductance;
+			if (iBranch.NbNdIn != Slots.NbNdA) rhs = -rhs;
+			if (Slots.AA != MINUS1) {
+				Values[Slots.AA] += conductance;
+				B.coeffRef(static_cast<long long> (Slots.NbNdA - 1ULL)) += rhs;
+			}
+			if (Slots.BB != MINUS1) {
+				Values[Slots.BB] += conductance;
+				B.coeffRef(static_cast<long long> (Slots.NbNdB - 1ULL)) -= rhs;
+			}
+			if (Slots.AB != MINUS1) {
+				Values[Slots.AB] -= conductance;
+				Values[Slots.BA] -= conductance;
 			}
 		}
 	}
@@ -84,9 +168,7 @@ bool LES(SparseMatrix<double>& S, /* System matrix as n*? sized vector.*/
  //   ConjugateGradient<SparseMatrix<double>, Eigen::Lower | Eigen::Upper  > solver;doesn't work on all models
  //   ConjugateGradient < SparseMatrix<double>, Eigen::Lower|Eigen::Upper, IncompleteCholesky<SparseMatrix<double> > solver; doesn't work at all
  //   BiCGSTAB<SparseMatrix<double>> solver;doesn't work
-	SimplicialLDLT<SparseMatrix<double>> solver;
-
-	solver.compute(S);
+	solver.factorize(S);
 	if (solver.info() != Success) {
 		// decomposition failed
 		prot << "\n problem solving equation system: decomposition failed ";
@@ -122,7 +204,7 @@ bool SingleEquation() // true, if successful
 		* As steam drum pressure is fixed, the steam drum is not included\n
 		*/
 	for (const auto& iBr : Nodes[1].NbBr) {
-		_branch iBranch = Branches[iBr];
+		const _branch& iBranch = Branches[iBr];
 		if (fabs(iBranch.dPLinear) > 1e-6) {
 			if (iBranch.NbNdOut == 1) {
 				numerator -= iBranch.dPConstant / iBranch.dPLinear;
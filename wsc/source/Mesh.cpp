@@ -27,10 +27,14 @@ int findMaxNodesConnected();
  */
 bool _node::isTee(_tube& firstTube, _tube& secondTube, _tube& thirdTube) {
 	double firstAngle, secondAngle, thirdAngle;
+	double firstCos, secondCos, thirdCos;
 
-	firstAngle = firstTube.Angle3d(secondTube);
-	secondAngle = firstTube.Angle3d(thirdTube);
-	thirdAngle = secondTube.Angle3d(thirdTube);
+	firstCos = firstTube.Cos3d(secondTube);
+	secondCos = firstTube.Cos3d(thirdTube);
+	thirdCos = secondTube.Cos3d(thirdTube);
+	firstAngle = acos(firstCos);
+	secondAngle = acos(secondCos);
+	thirdAngle = acos(thirdCos);
 	if (Base.showMeshDetail) {
 		prot << "\n iNode " << Number;
 		prot << "\n firstTb " << firstTube.Number << " secondTb " << secondTube.Number << " thirdTb " << thirdTube.Number;
@@ -57,6 +61,19 @@ bool _node::isTee(_tube& firstTube, _tube& secondTube, _tube& thirdTube) {
 		NbBrTStraight[0] = firstTube.NbBr;  // Branch numbers that are straight (inline) at a T-piece
 		NbBrTStraight[1] = secondTube.NbBr; // Branch numbers that are straight (inline) at a T-piece
 		NbBrTOff = thirdTube.NbBr;          // Branch number that branches off at a T-piece (only one branch)
+		// angles for both cases of flow direction, dpBranch only picks them (AngleTee)
+		bool firstStarts = firstTube.PointIn == NbPt;
+		bool secondStarts = secondTube.PointIn == NbPt;
+		bool thirdStarts = thirdTube.PointIn == NbPt;
+		if (firstStarts != secondStarts) firstCos = -firstCos;
+		if (firstStarts != thirdStarts) secondCos = -secondCos;
+		if (secondStarts != thirdStarts) thirdCos = -thirdCos;
+		AngleT[0][0] = acos(firstCos);
+		AngleT[0][1] = acos(-firstCos);
+		AngleT[1][0] = acos(secondCos);
+		AngleT[1][1] = acos(-secondCos);
+		AngleT[2][0] = acos(thirdCos);
+		AngleT[2][1] = acos(-thirdCos);
 // ------------------------------------------------
 // set orientation of Tee piece
 // ----------------------------------------------
@@ -165,17 +182,70 @@ void determineTee() {
 	return;
 }
 
+double _node::AngleTee(const _tube& first, const _tube& second) const {
+	// position in Tee: 0, 1 straight, 2 off
+	auto position = [this](const _tube& Tube) -> int {
+		if (Tube.Number == NbTbTStraight[0]) return 0;
+		if (Tube.Number == NbTbTStraight[1]) return 1;
+		if (Tube.Number == NbTbTOff) return 2;
+		return -1;
+	};
+	int firstPos = position(first);
+	int secondPos = position(second);
+	if (!IsT || firstPos < 0 || secondPos < 0 || firstPos == secondPos) {
+		return first.Angle3d(second);
+	}
+	// pair 0: straight-straight, 1: straight[0]-off, 2: straight[1]-off
+	int pair = firstPos + secondPos - 1;
+	bool sameDirection = (first.PointIn == NbPt) == (second.PointIn == NbPt);
+	return AngleT[pair][sameDirection ? 0 : 1];
+}
+
+/// copies the Tee data (as set by isTee()) of node From to node To
+static void copyTee(const _node& From, _node& To) {
+	To.IsT = From.IsT;
+	To.NbTbTStraight[0] = From.NbTbTStraight[0];
+	To.NbTbTStraight[1] = From.NbTbTStraight[1];
+	To.NbTbTOff = From.NbTbTOff;
+	To.NbBrTStraight[0] = From.NbBrTStraight[0];
+	To.NbBrTStraight[1] = From.NbBrTStraight[1];
+	To.NbBrTOff = From.NbBrTOff;
+	To.TOrientation = From.TOrientation;
+	for (int i = 0; i < 3; ++i) {
+		To.AngleT[i][0] = From.AngleT[i][0];
+		To.AngleT[i][1] = From.AngleT[i][1];
+	}
+	return;
+}
+
+void _nodeBranches::build() {
+	Start.assign(Nodes.size() + 1, 0);
+	Br.clear();
+	for (size_t iNd = 0; iNd < Nodes.size(); ++iNd) {
+		Start[iNd] = Br.size();
+		Br.insert(Br.end(), Nodes[iNd].NbBr.begin(), Nodes[iNd].NbBr.end());
+	}
+	Start[Nodes.size()] = Br.size();
+	return;
+}
+
 /**
- * \brief sets up the mesh (nodes, branches)
+ * \brief determines nodes and branches from points and tubes
  *
- * \return int error code
+ * the tubes are reversed to the direction of their branch
+ * \param [out] Topology isReversed is set for the reversed tubes
  */
-int Mesh() {
+static void determineMesh(_meshTopology& Topology) {
 	/* Local variables */
-	int j;
 	size_t PtTbOut, iPt,
 		iTb; // , iBr, iNd;
-	double hdiff, angle1; // ,
+	double hdiff;
+
+	Topology.isReversed.assign(Tubes.size(), 0);
+	Topology.PointTubes.resize(Points.size());
+	for (iPt = 0; iPt < Points.size(); ++iPt) {
+		Topology.PointTubes[iPt] = Points[iPt].NbTb;
+	}
 
 	Nodes.push_back(_node());
 	//! per definition point 0 and node 0 is drum
@@ -204,14 +274,12 @@ int Mesh() {
 			prot << "\nError: Only one tube to point " << iPoint.Number << " see <projectname>TubesPoints.dxf and check input data";
 			Print2dxf(ShowMode::TubesPoints);
 			processError(iPoint.Number, "only one tube to point");
-			exit(1);
 		}
 		if (iPoint.NoTb == 0) {// as the points are defined as starting or end points of tubes this should not happen
 			cout << "\nPoint " << iPoint.Number << " is not connected to tube. see <projectname>TubesPoints.dxf and check input data";;
 			prot << "\nPoint " << iPoint.Number << " is not connected to tube. see <projectname>TubesPoints.dxf and check input data";;
 			Print2dxf(ShowMode::TubesPoints);	
 			processError(iPoint.Number, "no tube connected to this point");
-			exit(1);
 		}
 	}
 	Nodes.shrink_to_fit();
@@ -266,6 +334,7 @@ int Mesh() {
 						prot << " tube :" << Tubes[nTb].Number << " reverseDirection " << endl;
 					}
 					Tubes[nTb].reverseDirection();
+					Topology.isReversed[nTb] = 1;
 				}
 				PtTbOut = Tubes[nTb].PointOut;
 				++mBr;
@@ -302,6 +371,7 @@ int Mesh() {
 										prot << "\n tube :" << Tubes[iTb1].Number << " reverseDirection ";
 									}
 									Tubes[iTb1].reverseDirection();
+									Topology.isReversed[iTb1] = 1;
 								}
 								mBranch->NbTbInBr.push_back(Tubes[iTb1].Number);
 								mBranch->mTbInBr++;
@@ -329,8 +399,7 @@ int Mesh() {
 						<< " has not a node at the end";
 					prot << "\nbranch starting with tube # " << mBranch->NbTbInBr[0]
 						<< " has not a node at the end";
-					prot.close();
-					exit(1);
+					throw _wscError("branch starting with tube # " + to_string(mBranch->NbTbInBr[0]) + " has not a node at the end");
 				}
 			EndOfThisBranch:
 				;
@@ -342,35 +411,50 @@ int Mesh() {
 		}
 	}
 	Branches.shrink_to_fit();
+	return;
+}
 
-	for (auto& iBranch : Branches) {
-		iBranch.deltaH = Nodes[iBranch.NbNdOut].Elev -
-			Nodes[iBranch.NbNdIn].Elev;
-		iBranch.minArea = 1e30;
-		for (auto jTb : iBranch.NbTbInBr) {
-			iBranch.minArea = fmin(Tubes[jTb].area * Tubes[jTb].NoParallel, iBranch.minArea);
+/**
+ * \brief takes nodes and branches from a mesh read from the binary model file
+ *
+ * the same state as after determineMesh(), the Tees are not yet determined
+ * \param [in] Topology valid mesh of the tubes
+ */
+static void takeMesh(const _meshTopology& Topology) {
+	_node NoTee;
+
+	Nodes = Topology.NodesMeshed;
+	for (auto& iNode : Nodes) {
+		copyTee(NoTee, iNode);
+		Points[iNode.NbPt].NbNd = iNode.Number;
+	}
+	for (size_t iPt = 0; iPt < Points.size(); ++iPt) {
+		Points[iPt].NbTb = Topology.PointTubes[iPt];
+	}
+	Branches = Topology.BranchesMeshed;
+	mNd = Nodes.size() - 1;
+	mBr = Branches.size() - 1;
+	for (size_t iTb = 0; iTb < Tubes.size(); ++iTb) {
+		if (Topology.isReversed[iTb]) {
+			Tubes[iTb].reverseDirection();
 		}
 	}
+	for (const auto& iBranch : Branches) {
+		for (auto iTb : iBranch.NbTbInBr) {
+			Tubes[iTb].NbBr = iBranch.Number;
+		}
+	}
+	return;
+}
 
-	StartResistance();
-
-	initFlow();
-
-	// -------------------------------------------------
-	// determine which nodes are T-piece
-	// and which branches are inline or branching off at this T-piece
-	// here only geometry is checked
-	// -------------------------------------------------
-	// condition: straight: same diameter and angle between tubes 0 or 180 deg,
-	// off: diameter <= straight, every angle
-	determineTee();
-
-	//	Print2dxf(PathFile, ShowMode::BranchesNodes);
+/**
+ * \brief determines angle between tubes in a branch and if it's an U or S arrangement
+ *
+ * at this place the flow directions are established
+ */
+static void determineUorS() {
+	double angle1;
 
-	//------------------------------------------------
-	// determine angle between tubes in a branch and if it's an U or S arrangement
-	// at this place the flow directions are established
-	//-------------------------------------------------
 	for (const auto& iBranch : Branches) {
 		//      cout<<" iBranch "<<iBranch<<endl;
 		if (iBranch.mTbInBr > 0) {
@@ -420,6 +504,85 @@ int Mesh() {
 		}
 	}
 
+	return;
+}
+
+/**
+ * \brief sets up the mesh (nodes, branches)
+ *
+ * takes the mesh from Topology if it is valid (read from the binary model file), otherwise determines it and fills Topology
+ * \param [in, out] Topology mesh of the binary model file
+ * \return int error code
+ */
+int Mesh(_meshTopology& Topology) {
+	/* Local variables */
+	int j;
+
+	if (Topology.isValid) {
+		takeMesh(Topology);
+	}
+	else {
+		determineMesh(Topology);
+		Topology.NodesMeshed = Nodes;
+		Topology.BranchesMeshed = Branches;
+	}
+
+	for (auto& iBranch : Branches) {
+		iBranch.deltaH = Nodes[iBranch.NbNdOut].Elev -
+			Nodes[iBranch.NbNdIn].Elev;
+		iBranch.minArea = 1e30;
+		for (auto jTb : iBranch.NbTbInBr) {
+			iBranch.minArea = fmin(Tubes[jTb].area * Tubes[jTb].NoParallel, iBranch.minArea);
+		}
+	}
+
+	for (auto& iTube : Tubes) {
+		iTube.setConstants();
+	}
+	StartResistance();
+
+	NodeBranches.build();
+	initFlow();
+
+	// -------------------------------------------------
+	// determine which nodes are T-piece
+	// and which branches are inline or branching off at this T-piece
+	// here only geometry is checked
+	// -------------------------------------------------
+	// condition: straight: same diameter and angle between tubes 0 or 180 deg,
+	// off: diameter <= straight, every angle
+	// the Tees, angles and U or S arrangement of a mesh read from the binary model file were determined on the same state
+	if (Topology.isValid) {
+		for (auto& iNode : Nodes) {
+			copyTee(Topology.NodesMeshed[iNode.Number], iNode);
+		}
+		for (size_t iTb = 0; iTb < Tubes.size(); ++iTb) {
+			Tubes[iTb].beta = Topology.beta[iTb];
+			Tubes[iTb].UorS = Topology.UorS[iTb];
+		}
+	}
+	else {
+		determineTee();
+		determineUorS();
+		for (auto& iNode : Nodes) {
+			copyTee(iNode, Topology.NodesMeshed[iNode.Number]);
+		}
+		Topology.beta.resize(Tubes.size());
+		Topology.UorS.resize(Tubes.size());
+		for (size_t iTb = 0; iTb < Tubes.size(); ++iTb) {
+			Topology.beta[iTb] = Tubes[iTb].beta;
+			Topology.UorS[iTb] = Tubes[iTb].UorS;
+		}
+		Topology.isValid = true;
+	}
+
+	//	Print2dxf(PathFile, ShowMode::BranchesNodes);
+
+	// U or S arrangement is known now
+	for (auto& iTube : Tubes) {
+		iTube.setConstants();
+	}
+
 	if (Base.showMesh) {
 		prot << "\n    *****************";
 		prot << "\n    * Mesh checking *";
@@ -65,7 +65,7 @@ int Print2dxf(ShowMode mode) {
 	outData.open(writefile.c_str());
 	if (!outData.good()) {
 		cout << "\n cannot open file " << writefile << endl;
-		exit(1);
+		throw _wscError("cannot open file " + writefile);
 	}
 	else {
 		error = DXFWrite(outData, mode);
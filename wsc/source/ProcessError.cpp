@@ -36,6 +36,5 @@ void processError(size_t iPt, const string& text) {
 		outData << "  0\nENDSEC\n  0\nSECTION\n  2\nOBJECTS\n  0\nENDSEC\n  0\nEOF" << std::endl;
 		outData.close();
 	}//file opened correctly
-	prot.close();
-	exit(1);
+	throw _wscError("error on " + text + ". Starting point " + to_string(iPt));
 }
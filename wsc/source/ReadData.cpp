@@ -11,29 +11,111 @@
 * \date   September 2021
 *********************************************************************/
 #include "stdafx.h"
+#include <charconv>
+#include <cstring>
+#include <string_view>
 #undef MAINFUNCTION
 #include "CommonHeader.h"
+#include "modelFile.h"
 
 using namespace std;
 
-void ErrorRead(ifstream& inData, size_t iTb, int NbLine, const string& text ){
+/*!
+ * \brief fields of one line of the data file, separated by blanks or tabs (a \\r of a Windows line end is a blank as well)
+ *
+ * extraction like istringstream: numbers are converted with from_chars,
+ * after an extraction failed all further extractions fail and the fields convert to false
+ */
+class _dataFields {
+public:
+	explicit _dataFields(string_view Line) : Pos(Line.data()), End(Line.data() + Line.size()) {}
+	explicit operator bool() const { return isGood; }
+	/// next field as text
+	_dataFields& operator>>(string& Word) {
+		if (skipBlanks()) {
+			const char* Begin = Pos;
+			while (Pos < End && !isBlank(*Pos)) ++Pos;
+			Word.assign(Begin, Pos);
+		}
+		return *this;
+	}
+	/// next character that is not blank
+	_dataFields& operator>>(char& Char) {
+		if (skipBlanks()) Char = *Pos++;
+		return *this;
+	}
+	/// next number, the number can be followed directly by other characters (f.i. 1.5abc gives 1.5, the next field is abc)
+	template <class T> _dataFields& operator>>(T& Number) {
+		if (skipBlanks()) {
+			if (*Pos == '+' && Pos + 1 < End && Pos[1] != '-') ++Pos;
+			from_chars_result Result = from_chars(Pos, End, Number);
+			if (Result.ec != errc()) {
+				isGood = false;
+			}
+			Pos = Result.ptr;
+		}
+		return *this;
+	}
+private:
+	const char* Pos;    ///< next character to read
+	const char* End;    ///< end of line
+	bool isGood = true; ///< false after an extraction failed
+	static bool isBlank(char Char) { return Char == ' ' || Char == '\t' || Char == '\r' || Char == '\v' || Char == '\f'; }
+	/// skips blanks, false (and fields are not good) if the end of line is reached
+	bool skipBlanks() {
+		if (!isGood) return false;
+		while (Pos < End && isBlank(*Pos)) ++Pos;
+		isGood = Pos < End;
+		return isGood;
+	}
+};
+
+void setControl(int Control) {
+	Base.Control = Control;
+	if (Control != 0) {
+		Base.showMesh = true;
+		Base.showEnth = (Control == 2 || Control == 10 || Control == 20);
+		Base.showDPTube = (Control == 3 || Control == 10 || Control == 13 || Control == 20);
+		Base.showDPBranch = (Control == 5 || Control == 10 || Control == 20);
+		Base.showNodePressure = (Control == 6 || Control == 10 || Control == 20);
+		Base.showFlow = (Control == 7 || Control == 10 || Control == 20);
+		Base.showReverse = (Control == 8 || Control == 10 || Control == 18 || Control == 20);
+		Base.showMeshDetail = (Control == 11 || Control == 20);
+		Base.showDPTubeDetail = (Control == 13 || Control == 20);
+		Base.showReverseDetail = (Control == 18 || Control == 20);
+	}
+}
+
+void setDrumProperties() {
+	double tSatDrum = H2O::satTemp(Drum.pMPa);
+	Drum.rhoW = 1. / H2O::specVol(tSatDrum, Drum.pMPa, WATER);
+	Drum.enthW = H2O::enth(tSatDrum, Drum.pMPa, WATER);
+	Drum.qSum = 0.;
+	Drum.enthEvap = H2O::enth(tSatDrum, Drum.pMPa, STEAM) - Drum.enthW;
+}
+
+void setDowncomerLevel(double LevelHighestPoint, double LevelLowestPoint) {
+	Base.DowncomerLevel = (LevelHighestPoint - LevelLowestPoint) * Base.LevelFact
+		+ LevelLowestPoint;
+	Drum.FlowSteam = Drum.qSum / Drum.enthEvap;
+	prot << "\n highest " << LevelHighestPoint << " LevelLowestPoint " << LevelLowestPoint;
+	prot << "\n downcomerlevel " << Base.DowncomerLevel;
+}
+
+void ErrorRead(size_t iTb, int NbLine, const string& text ){
 	cout << "\n tube # " << iTb << text;
 	cout << "\n error found in data file line " <<NbLine;
 	prot << "\n tube # " << iTb << text;
 	prot << "\n error found in data file line " << NbLine;
-	inData.close();
-	prot.close();
-	exit(1);
+	throw _wscError("tube # " + to_string(iTb) + text + ", error found in data file line " + to_string(NbLine));
 
    return;
 }
 
-void ErrorParsing(ifstream& inData, int NbLine) {
+void ErrorParsing(int NbLine) {
 	cout << "\n error found in data file line " <<NbLine  << " (line parsing)";
 	prot << "\n error found in data file line " <<NbLine  << " (line parsing)";
-	inData.close();
-	prot.close();
-	exit(1);
+	throw _wscError("error found in data file line " + to_string(NbLine) + " (line parsing)");
 	return;
 }
 
@@ -41,22 +123,17 @@ void ErrorParsing(ifstream& inData, int NbLine) {
 int readData() {
 
 	/* Local variables */
-	string Project, iname, line, TubeName;
-	int InDataLine = 3;
+	string Project, iname, TubeName;
 	size_t p1, p2, iTb, NbPt;
 	int control = 0;
 	double dx, dy, dz;
 	double q1, x, y, z, npar1;
 	double dOut, BendRadius, fAdd, fHeat, dOrificeIn, dOrificeOut, EnthGiven;
 	double StartAngle, EndAngle, CenterX, CenterY, CenterZ, ArcNx, ArcNy, ArcNz;
-	double thk, tSatDrum;
+	double thk;
 	double LevelHighestPoint = 0.;
 	double LevelLowestPoint = 100.;
-	double LevelFact = 0.;
-
-	ifstream inData;
-	// Set exceptions to be thrown on failure
-	//inData.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	_wscbTube Geometry;
 
 	/*     ---------------------------- */
 	/*     initialize data */
@@ -66,18 +143,27 @@ int readData() {
 
 	iname = PathFile + ".dat";
 
-	try {
-		inData.open(iname.c_str());
-	}
-	catch (system_error& e) {
-		cout << e.code().message() << endl;
-		exit(1);
+	/**
+	 * the data file is mapped into memory and split into lines, the line number of Lines[i] is i + 1
+	 */
+	_mappedFile inData(iname);
+	vector<string_view> Lines;
+	{
+		const char* Begin = inData.data();
+		const char* End = Begin + inData.size();
+		Lines.reserve(count(Begin, End, '\n') + 1);
+		while (Begin < End) {
+			const char* EndOfLine = static_cast<const char*>(memchr(Begin, '\n', End - Begin));
+			if (EndOfLine == nullptr) EndOfLine = End;
+			Lines.emplace_back(Begin, EndOfLine - Begin);
+			Begin = EndOfLine + 1;
+		}
 	}
-	if (getline(inData, line).good()) {
-		istringstream iss(line);
-		if (!(iss >> Project)) ErrorParsing(inData, 1); 
+	if (Lines.size() > 0) {
+		_dataFields iss(Lines[0]);
+		if (!(iss >> Project)) ErrorParsing(1); 
 	}
-	else ErrorParsing(inData, 1);
+	else ErrorParsing(1);
 	/**the first 2 lines in input data file contain some general data
 	*
 	* first line
@@ -88,66 +174,72 @@ int readData() {
 	* control: number, which data should be written to protocol file (for debugging)\n
 	* Base.Method: character to indicate calculation method for 2-phase flow
 	 */
-	if (getline(inData, line).good()) {
-		istringstream iss(line);
+	if (Lines.size() > 1) {
+		_dataFields iss(Lines[1]);
 		if (!(iss >> Base.maxit >> Base.tol >> control >> Base.Method)) {
-			ErrorParsing(inData, 2);
+			ErrorParsing(2);
 		} // error
 	}
 	else {
-		ErrorParsing(inData, 2);
+		ErrorParsing(2);
 	}
 	prot << " maxit " << Base.maxit << " control " << control;
-	if (control != 0) {
-		Base.showMesh = true;
-		Base.showEnth = (control == 2 || control == 10 || control == 20);
-		Base.showDPTube = (control == 3 || control == 10 || control == 13 || control == 20);
-		Base.showDPBranch = (control == 5 || control == 10 || control == 20);
-		Base.showNodePressure = (control == 6 || control == 10 || control == 20);
-		Base.showFlow = (control == 7 || control == 10 || control == 20);
-		Base.showReverse = (control == 8 || control == 10 || control == 18 || control == 20);
-		Base.showMeshDetail = (control == 11 || control == 20);
-		Base.showDPTubeDetail = (control == 13 || control == 20);
-		Base.showReverseDetail = (control == 18 || control == 20);
-	}
+	setControl(control);
 	/**
 	 * second line
 	 *
 	 * Drum.pMPa: drum pressure [MPa]\n
 	 * Base.Rough: tube roughness [mm]\n
-	 * LevelFact: a factor to give a level between highest and lowest heated point, used to determine downcomers [0...1]\n
+	 * Base.LevelFact: a factor to give a level between highest and lowest heated point, used to determine downcomers [0...1]\n
 	 * Drum.LevelW: water level in drum relative to drum center, above positive, below negative [m]\n
 	 * Drum.dpDyn: dynamic pressure drop in drum due to drum internals (baffles, cyclones etc.) [Pa]\n
 	 * Base.CRStart: initial guess of circulation ratio for the first branch flow estimation initFlow()
 	 */
 
-	if (getline(inData, line).good()) {
-		istringstream iss(line);
-		if (!(iss >> Drum.pMPa >> Base.Rough >> LevelFact >> Drum.LevelW >> Drum.dpDyn >> Base.CRStart)) {
-			ErrorParsing(inData, 3);
+	if (Lines.size() > 2) {
+		_dataFields iss(Lines[2]);
+		if (!(iss >> Drum.pMPa >> Base.Rough >> Base.LevelFact >> Drum.LevelW >> Drum.dpDyn >> Base.CRStart)) {
+			ErrorParsing(3);
 		} // error
 	}
 	else {
-		ErrorParsing(inData, 3);
+		ErrorParsing(3);
 	}
 	Base.Rough /= 1e3; // conversion to m
-	tSatDrum = H2O::satTemp(Drum.pMPa);
-	Drum.rhoW = 1. / H2O::specVol(tSatDrum, Drum.pMPa, WATER);
-	Drum.enthW = H2O::enth(tSatDrum, Drum.pMPa, WATER);
-	Drum.qSum = 0.;
-	Drum.enthEvap = H2O::enth(tSatDrum, Drum.pMPa, STEAM) - Drum.enthW;
+	setDrumProperties();
 	Drum.dpDyn *= 1e3; // conversion to Pa
-	mTb = 0;
-	Tubes.push_back(_tube());
-	//   cout << Tube[0].PointIn << " " << Tube[0].Points[1];
+	/**
+	 * counting pass: the highest point number and the highest tube number give the size of Points and Tubes,
+	 * so they are not resized while reading. Lines that cannot be read are left to the reading below for the error message
+	 */
+	size_t iTubeData = 3;
 	mPt = 0;
-	Points.push_back(_point());
+	for (; iTubeData < Lines.size(); iTubeData++) {
+		_dataFields iss(Lines[iTubeData]);
+		if (iss >> NbPt) {
+			mPt = max(mPt, NbPt);
+		}
+		else if (_dataFields(Lines[iTubeData]) >> TubeName && TubeName == "TubeData") {
+			break;
+		}
+	}
+	mTb = 0;
+	for (size_t iLine = iTubeData + 2; iLine < Lines.size(); iLine += 2) {
+		_dataFields iss(Lines[iLine]);
+		if (iss >> iTb) {
+			mTb = max(mTb, iTb);
+		}
+	}
+	// To avoid Points index to be different to Number, if we have gaps (1,2,3,5,...) 
+	Points.resize(mPt + 1);
+	Tubes.resize(mTb + 1);
+	TubesOutput.resize(mTb + 1);
 	/**
 	 * loop through data file until no more data left
 	 */
-	while (getline(inData, line).good()) {
-		InDataLine++;
-		istringstream iss(line);
+	for (size_t iLine = 3; iLine < iTubeData; iLine++) {
+		int InDataLine = static_cast<int>(iLine) + 1;
+		_dataFields iss(Lines[iLine]);
 /**
  * 1.) reading point data
  * 
@@ -158,20 +250,7 @@ int readData() {
  * The point coordinates are kept in mm because they are needed later in .dxf file in mm\n
  */
 		if (!(iss >> NbPt >> x >> y >> z)) {
-			istringstream iss1(line);
-			if (!(iss1 >> TubeName)) {
-				ErrorParsing(inData, InDataLine);
-			}
-			else {
-				if (TubeName == "TubeData") {
-					break;
-				}
-			}
-		}
-// To avoid Points index to be different to Number, if we have gaps (1,2,3,5,...) 
-		if (NbPt > mPt) {
-			Points.resize(NbPt + 1);
-			mPt = NbPt;
+			ErrorParsing(InDataLine);
 		}
 		Points[NbPt].Number = NbPt;
 		Points[NbPt].xCoord = x; // ->mm
@@ -180,9 +259,9 @@ int readData() {
 		LevelHighestPoint = fmax(LevelHighestPoint, z / 1e3);// ->m
 		LevelLowestPoint = fmin(LevelLowestPoint, z / 1e3);// ->m
 	}
-	while (getline(inData, line).good()) {
-		InDataLine++;
-		istringstream iss(line);
+	for (size_t iLine = iTubeData + 1; iLine < Lines.size(); iLine += 2) {
+		int InDataLine = static_cast<int>(iLine) + 1;
+		_dataFields iss(Lines[iLine]);
 		/**
 		 * 1.) reading of data
 		 *
@@ -192,11 +271,11 @@ int readData() {
 		 *
 		 */
 		if (!(iss >> TubeName)) {
-			ErrorParsing(inData, InDataLine);
+			ErrorParsing(InDataLine);
 		} // error
-		if (getline(inData, line).good()) {
+		if (iLine + 1 < Lines.size()) {
 			InDataLine++;
-			istringstream iss1(line);
+			_dataFields iss1(Lines[iLine + 1]);
 			/**
 			 * second line of tube data
 			 *
@@ -222,13 +301,10 @@ int readData() {
 			if (!(iss1 >> iTb >> p1 >> p2 >> dOut >>thk >> BendRadius >> npar1 >> fAdd >> q1 >> fHeat >>
 				 dOrificeIn >> dOrificeOut >> EnthGiven >>StartAngle >> EndAngle >>CenterX >>CenterY >>CenterZ >>
 				ArcNx >>				ArcNy >>				ArcNz 				)) {
-				ErrorParsing(inData, InDataLine);
+				ErrorParsing(InDataLine);
 			} // error
-			while (iTb > mTb) {
-				Tubes.push_back(_tube());
-				mTb = iTb;
-			}
 			_tube* iTube = &Tubes[iTb];
+			_tubeOutput* iTubeOut = &TubesOutput[iTb];
 				/**
 			 * 2.) setting max. number of points and tubes
 			 *
@@ -242,47 +318,44 @@ int readData() {
 			 */
 			if (iTube->PointIn != MINUS1 && iTube->PointOut != MINUS1) {
 				processError(iTube->PointIn, "tube already defined");
-				ErrorRead(inData, iTb,InDataLine, " : this tube is already defined");
+				ErrorRead(iTb,InDataLine, " : this tube is already defined");
 			}
 			if (p1 > mPt || p2 > mPt) {
-				ErrorRead(inData, iTb, InDataLine, " : tube point number higher than maximum number");
+				ErrorRead(iTb, InDataLine, " : tube point number higher than maximum number");
 			}
 			iTube->Number = iTb;
 			iTube->PointIn = p1;
 			iTube->PointOut = p2;
 
 			if (dOut - thk * 2. < 1.) {
-				ErrorRead(inData, iTb, InDataLine, " inside diameter too small");
+				ErrorRead(iTb, InDataLine, " inside diameter too small");
 			}
-			iTube->Name = TubeName;
-			iTube->Dia = (dOut - thk * 2.) / 1e3; // ->m
-			iTube->area = M_PI_4 * (iTube->Dia * iTube->Dia);// ->m2
-
- 			iTube->RadiusBend = BendRadius / 1e3;   /* -> m */
+			iTubeOut->Name = TubeName;
 			_point* PtIn = &Points[iTube->PointIn];
 			_point* PtOut = &Points[iTube->PointOut];
+			dx = PtOut->xCoord - PtIn->xCoord;
+			dy = PtOut->yCoord - PtIn->yCoord;
 			dz = PtOut->zCoord - PtIn->zCoord;
-			iTube->Height = dz / 1e3; // ->m
-			if (Tubes[iTb].RadiusBend < 1e-6) {
-				dx = PtOut->xCoord - PtIn->xCoord;
-				dy = PtOut->yCoord - PtIn->yCoord;
-				iTube->Length = sqrt(dx * dx + dy * dy + dz * dz) / 1e3;// ->m
-			}
-			else {
-				iTube->OCSStartAngle = StartAngle; //in deg
-				iTube->OCSEndAngle = EndAngle;     //in deg
-				iTube->OCSCenterX = CenterX;       // ->mm
-				iTube->OCSCenterY = CenterY;       // ->mm
-				iTube->OCSCenterZ = CenterZ;       // ->mm
-				iTube->Nx = ArcNx;
-				iTube->Ny = ArcNy;
-				iTube->Nz = ArcNz;
-				iTube->beta = EndAngle - StartAngle; //in deg
-				if (iTube->beta < 0.) iTube->beta += 360.;
-				iTube->Length = iTube->beta * M_PI / 180. * iTube->RadiusBend;// in m
+			// the same calculation as for the binary model file in dxf2wsc
+			wscbGeometry(dOut, thk, BendRadius, dx, dy, dz, StartAngle, EndAngle, Geometry);
+			iTube->Dia = Geometry.Dia;
+			iTube->area = Geometry.area;
+			iTube->RadiusBend = Geometry.RadiusBend;
+			iTube->Height = Geometry.Height;
+			iTube->Length = Geometry.Length;
+			if (Tubes[iTb].RadiusBend >= 1e-6) {
+				iTubeOut->OCSStartAngle = StartAngle; //in deg
+				iTubeOut->OCSEndAngle = EndAngle;     //in deg
+				iTubeOut->OCSCenterX = CenterX;       // ->mm
+				iTubeOut->OCSCenterY = CenterY;       // ->mm
+				iTubeOut->OCSCenterZ = CenterZ;       // ->mm
+				iTubeOut->Nx = ArcNx;
+				iTubeOut->Ny = ArcNy;
+				iTubeOut->Nz = ArcNz;
+				iTube->beta = Geometry.beta; //in deg
 			}
 			if (iTube->Length < 1e-3) {
-				ErrorRead(inData, iTb, InDataLine, " length too short");				
+				ErrorRead(iTb, InDataLine, " length too short");				
 			}
 			PtIn->NoTb++;
 			PtIn->NbTb.push_back(iTb);
@@ -290,23 +363,22 @@ int readData() {
 			PtOut->NbTb.push_back(iTb);
 
 			iTube->q = q1;
-			Drum.qSum += q1;
 			if (npar1 < 1.) {
-				ErrorRead(inData, iTb, InDataLine, " too few number of parallel tubes");	
+				ErrorRead(iTb, InDataLine, " too few number of parallel tubes");	
 			}
 			iTube->NoParallel = npar1;
 			iTube->ksiAdd = fAdd;
 			if (fHeat < .001 || fHeat > 2.) {
-				ErrorRead(inData, iTb, InDataLine, " wrong heating position factor");	
+				ErrorRead(iTb, InDataLine, " wrong heating position factor");	
 			}
 			iTube->FactHeat = fHeat;
 			//         Tube[iTb].NoConnect = (double) nk1;
 			if (dOrificeIn / 1e3 > iTube->Dia || dOrificeIn < 0.) {
-				ErrorRead(inData, iTb, InDataLine," wrong inlet orifice diameter");	
+				ErrorRead(iTb, InDataLine," wrong inlet orifice diameter");	
 			}
 			iTube->DiaOrificeIn = dOrificeIn / 1e3;// ->m
 			if (dOrificeOut / 1e3 > iTube->Dia || dOrificeOut < 0.) {
-				ErrorRead(inData, iTb, InDataLine, " wrong outlet orifice diameter");
+				ErrorRead(iTb, InDataLine, " wrong outlet orifice diameter");
 			}
 			iTube->DiaOrificeOut = dOrificeOut / 1e3;// ->m
 			iTube->EnthInGiven = EnthGiven;
@@ -317,12 +389,11 @@ int readData() {
 			break;
 		}
 	}
-	inData.close();
-	Base.DowncomerLevel = (LevelHighestPoint - LevelLowestPoint) * LevelFact
-		+ LevelLowestPoint;
-	Drum.FlowSteam = Drum.qSum / Drum.enthEvap;
-	prot << "\n highest " << LevelHighestPoint << " LevelLowestPoint " << LevelLowestPoint;
-	prot << "\n downcomerlevel " << Base.DowncomerLevel;
+	// summed up in the order of the tube numbers, as in readModel
+	for (const auto& iTube : Tubes) {
+		Drum.qSum += iTube.q;
+	}
+	setDowncomerLevel(LevelHighestPoint, LevelLowestPoint);
 	Points.shrink_to_fit();
 	Tubes.shrink_to_fit();
 
@@ -42,12 +42,12 @@ int _branch::reverseDirection() {
 		if (Base.showReverse) {
 			prot << "\n start tube reverse direction NbTb : " << NbTb << endl;
 		}
-		::Tubes[NbTb].reverseDirection();
+		Tubes[NbTb].reverseDirection();
 		if (Base.showReverse) {
 			prot << "\n  iBr  NbTb Startpoint Endpoint BranchNbPtIn BranchNbPtOut";
 			prot << "\n" << setw(5) << Number << " " << " " << setw(5)
-				<< NbTb << " " << setw(5) << ::Tubes[NbTb].PointIn << " "
-				<< setw(5) << ::Tubes[NbTb].PointOut << " " << setw(5)
+				<< NbTb << " " << setw(5) << Tubes[NbTb].PointIn << " "
+				<< setw(5) << Tubes[NbTb].PointOut << " " << setw(5)
 				<< NbPtIn << " " << setw(5) << NbPtOut;
 		}
 	}
@@ -182,5 +182,6 @@ void _tube::reverseDirection() {
 	ddummy = DiaOrificeIn;
 	DiaOrificeIn = DiaOrificeOut;
 	DiaOrificeOut = ddummy;
+	setConstants(); // outlet orifice changed
 	return;
 }
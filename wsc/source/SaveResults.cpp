@@ -20,7 +20,7 @@ int SaveResults() {
 	}
 	catch (system_error& e) {
 		cerr << rname << " : " << e.code().message() << endl;
-		exit(1);
+		throw _wscError(rname + " : " + e.code().message());
 	}
 	result << "  iTb\tPtIn\tPtOut\tg\txIn\txOut\tvoid\tbeta\tUorS\tHeatFlux"
 		<<"\tdpIn\tdpOut\tdpdyn\tdpstat\trhoIn\trhoOut"
@@ -31,7 +31,7 @@ int SaveResults() {
 	result.setf(ios::fixed, ios::floatfield);
 	/// for each tube following data is saved:\n
 	for (auto& iTube : Tubes) {
-		iTube.Criteria();
+		iTube.Criteria(*ActiveModel);
 		iTube.Steiner(iTube.pPaOut, iTube.xOut);
 
 		/// tube number (it's the same as in input file),\n
@@ -88,46 +88,47 @@ int SaveResults() {
 			//                << setw(8) << setprecision(2) << iTube.rhoMean
 			//<< setw(8) << setprecision(2) << iTube.velWater
 			<< setw(8) << setprecision(2) << iTube.velOut << "\t";
-		if (iTube.q > 0. && iTube.SafetyFactor > 0.) {
-			result << setw(8) << setprecision(2) << iTube.SafetyFactor << "\t";
+		const _tubeOutput& iTubeOut = TubesOutput[iTube.Number];
+		if (iTube.q > 0. && iTubeOut.SafetyFactor > 0.) {
+			result << setw(8) << setprecision(2) << iTubeOut.SafetyFactor << "\t";
 		}
 		else {
 			result << "-" << "\t";
 		}
-		if (iTube.q > 0. && iTube.SafetyKorneev > 0.) {
-			result << setw(8) << setprecision(2) << iTube.SafetyKorneev << "\t";
+		if (iTube.q > 0. && iTubeOut.SafetyKorneev > 0.) {
+			result << setw(8) << setprecision(2) << iTubeOut.SafetyKorneev << "\t";
 		}
 		else {
 			result << "-" << "\t";
 		}
 		if (iTube.q >0. && iTube.xOut > 1e-3 && fabs(iTube.Height / iTube.Length) < 0.174) {
-			result << setw(14) << setprecision(2) << iTube.SafetyTaitel_Dukler << "\t";
-			result << setw(8) << setprecision(2) << iTube.SafetySteiner << "\t";
+			result << setw(14) << setprecision(2) << iTubeOut.SafetyTaitel_Dukler << "\t";
+			result << setw(8) << setprecision(2) << iTubeOut.SafetySteiner << "\t";
 		}
 		else {
 			result << "-" << "\t" << "-" << "\t";
 		}
 		
-	if (iTube.q > 0. && iTube.SafetyKonkov > 0.) {
-		result << setw(8) << setprecision(2) << iTube.SafetyKonkov << "\t";
+	if (iTube.q > 0. && iTubeOut.SafetyKonkov > 0.) {
+		result << setw(8) << setprecision(2) << iTubeOut.SafetyKonkov << "\t";
 		}
 		else {
 			result << "-" << "\t";
 		}
-	if (iTube.q > 0. && iTube.SafetyDoroshchuk > 0.) {
-		result << setw(11) << setprecision(2) << iTube.SafetyDoroshchuk << "\t";
+	if (iTube.q > 0. && iTubeOut.SafetyDoroshchuk > 0.) {
+		result << setw(11) << setprecision(2) << iTubeOut.SafetyDoroshchuk << "\t";
 		}
 		else {
 			result << "-" << "\t";
 		}
-		if (iTube.q > 0. && iTube.SafetyKatto_Ohno > 0.) {
-			result << setw(11) << setprecision(2) << iTube.SafetyKatto_Ohno << "\t";
+		if (iTube.q > 0. && iTubeOut.SafetyKatto_Ohno > 0.) {
+			result << setw(11) << setprecision(2) << iTubeOut.SafetyKatto_Ohno << "\t";
 		}
 		else {
 			result << "-" << "\t";
 		}
-		if (iTube.q > 0. && iTube.SafetyGroeneveld > 0.) {
-			result << setw(11) << setprecision(2) << iTube.SafetyGroeneveld << "\t";
+		if (iTube.q > 0. && iTubeOut.SafetyGroeneveld > 0.) {
+			result << setw(11) << setprecision(2) << iTubeOut.SafetyGroeneveld << "\t";
 		}
 		else {
 			result << "-" << "\t";
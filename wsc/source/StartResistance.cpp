@@ -112,7 +112,7 @@ int StartResistance() {
 				iTube->LengthSection = iTube->Length;
 				iTube->HeightSection = 0.;
 				iTube->HeatSection = iTube->q;
-				iTube->dpTube(ksiIn, ksiOut, iBranch.g);
+				iTube->dpTube(*ActiveModel, ksiIn, ksiOut, iBranch.g);
 				//               iTube->pPaOut = iTube->pPaIn - iTube->dpdyn - iTube->dpstat - iTube->dpIn - iTube->dpOut;
 			}
 			iBranch.dPdyn += iTube->dpdyn + iTube->dpIn + iTube->dpOut;
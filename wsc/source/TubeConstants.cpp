@@ -0,0 +1,45 @@
+//#include "stdafx.h"
+#include "CommonHeader.h"
+/* ----------------------------------------------------------------------- */
+/*     function sets the data of a tube that only depends on geometry      */
+/* ----------------------------------------------------------------------- */
+
+void _tube::setConstants() {
+	RelRough = Base.Rough / Dia;
+	/**
+	 * correction factor eta of ksiBend for smooth bends close to each other in "S" or "U" arrangement,\n
+	 * fitted as polynomial of distance between the bends / Dia
+	 */
+	etaBendUS = 0.;
+	if (UorS != USArrangement::No) {
+		double dist = Length - 2. * RadiusBend;
+		if (dist < 1e-3) {
+			if (UorS == USArrangement::S) {
+				etaBendUS = 1.1964706; // is  1.0982353 *2. -1.;
+			}
+			else {
+				etaBendUS = 0.21844428; // is  .60922214* 2.-1.;
+			}
+		}
+		else {
+			static const double usS[7] = { 1.0982353, -.20151263, .05792232, -.0080823559,
+				6.0783983e-4, -2.3790387e-5, 3.8269694e-6 };
+			static const double usU[7] = { .60922214, .060370803, -.0072293581, 7.8684409e-4,
+				-8.0123244e-5, 4.8920378e-6, -1.1609907e-7 };
+			const double* us = UorS == USArrangement::S ? usS : usU;
+			for (int j = 0; j < 7; ++j) {
+				etaBendUS += us[j] * pow(dist / Dia, j);
+			}
+		}
+	}
+	/**
+	 * outlet orifice (sharp edged, Brandt): the parts of the resistance factor without Reynolds number
+	 */
+	ksi0OrificeOut = 0.;
+	ksiPhiOrificeOut = 0.;
+	if (DiaOrificeOut > 0.) {
+		double m1 = DiaOrificeOut / Dia;
+		ksi0OrificeOut = 0.5 * (1. - m1) + (1. - m1) * (1. - m1) + 1.35 * sqrt(1. - m1) * (1. - m1);
+		ksiPhiOrificeOut = 0.39 * exp(-18.34 * pow(m1, 3.5));
+	}
+} /* setConstants */
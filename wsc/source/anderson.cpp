@@ -0,0 +1,91 @@
+/*****************************************************************//**
+ * \file   anderson.cpp
+ * \brief  Anderson acceleration of the damped fixed point iteration of the flow in branches
+ *
+ * the fixed point iteration uses g + damping * (gNew - g) as new flow\n
+ * Anderson acceleration (also known as DIIS) keeps the differences of the last Base.AndersonWindow flows and residuals (gNew - g)\n
+ * and mixes them with the coefficients gamma that minimize the linear combination of the residuals (least squares)\n
+ * new flow = g + damping * f - (dG + damping * dF) * gamma\n
+ * if this would change the sign of the flow in one branch, the plain damped step is used (Step())
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#undef MAINFUNCTION
+#include <Eigen/Dense>
+#include "CommonHeader.h"
+
+static const double damping = 0.2; ///< same damping as in Step()
+
+// the history is kept per thread and belongs to model HistModel
+static thread_local MatrixXd dF;    ///< differences of residuals (columns, used as ring buffer)
+static thread_local MatrixXd dG;    ///< differences of flows (columns, used as ring buffer)
+static thread_local VectorXd fLast; ///< residual of last iteration step
+static thread_local VectorXd gLast; ///< flow of last iteration step
+static thread_local size_t NoHist = 0;   ///< number of valid columns in dF, dG
+static thread_local size_t iNextCol = 0; ///< column to be overwritten next
+static thread_local bool isLast = false; ///< fLast, gLast are valid
+static thread_local size_t HistModel = 0; ///< model of the history
+
+void AndersonReset() {
+	NoHist = 0;
+	iNextCol = 0;
+	isLast = false;
+}
+
+bool AndersonUpdate() {
+	long long NoBr = static_cast<long long> (mBr + 1);
+	long long Window = static_cast<long long> (max(Base.AndersonWindow, size_t(1)));
+	if (dF.rows() != NoBr || dF.cols() != Window || HistModel != ActiveModel->Id) {
+		dF.resize(NoBr, Window);
+		dG.resize(NoBr, Window);
+		AndersonReset();
+		HistModel = ActiveModel->Id;
+	}
+	VectorXd g(NoBr), f(NoBr);
+	for (const auto& iBranch : Branches) {
+		long long iBr = static_cast<long long> (iBranch.Number);
+		g(iBr) = iBranch.g;
+		f(iBr) = iBranch.isFlowSet2zero ? 0. : iBranch.gNew - iBranch.g;
+	}
+	if (isLast) {
+		long long iCol = static_cast<long long> (iNextCol);
+		dF.col(iCol) = f - fLast;
+		dG.col(iCol) = g - gLast;
+		iNextCol = (iNextCol + 1) % static_cast<size_t> (Window);
+		NoHist = min(NoHist + 1, static_cast<size_t> (Window));
+	}
+	fLast = f;
+	gLast = g;
+	isLast = true;
+	if (NoHist == 0) return false; // no history yet: damped step
+
+	long long NoCols = static_cast<long long> (NoHist);
+	VectorXd gamma = dF.leftCols(NoCols).colPivHouseholderQr().solve(f);
+	VectorXd gNext = g + damping * f - (dG.leftCols(NoCols) + damping * dF.leftCols(NoCols)) * gamma;
+
+	prot << "\n Anderson iteration " << Base.iterg << " coefficients";
+	for (long long iCol = 0; iCol < NoCols; ++iCol) {
+		prot << " " << gamma(iCol);
+	}
+	for (const auto& iBranch : Branches) {
+		long long iBr = static_cast<long long> (iBranch.Number);
+		if (iBranch.g > 0. && gNext(iBr) <= 0.) {
+			prot << " -> sign of flow in branch " << iBranch.Number << " would change, damped step" << endl;
+			return false;
+		}
+	}
+	prot << endl;
+
+	for (auto& iBranch : Branches) {
+		iBranch.gPrev3 = iBranch.gPrev2;
+		iBranch.gPrev2 = iBranch.gPrev1;
+		iBranch.gPrev1 = iBranch.g;
+		if (iBranch.isFlowSet2zero) continue;
+		iBranch.g = gNext(static_cast<long long> (iBranch.Number));
+		if (fabs(iBranch.g) < 1e-5) {
+			iBranch.g = 0.;
+		}
+	}
+	return true;
+}
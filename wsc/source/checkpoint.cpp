@@ -0,0 +1,228 @@
+/*****************************************************************//**
+ * \file   checkpoint.cpp
+ * \brief saving and reading the state of the flow iteration (checkpoint) to restart from it
+ *
+ * binary file, native byte order:\n
+ * header: identifier "WSCCHKP", version, hash of the model (network and geometry), hash of the load case,\n
+ * number of nodes, branches and tubes, iteration step\n
+ * then the state of all nodes, branches and tubes
+ *
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#include <cstdint>
+#undef MAINFUNCTION
+#include "CommonHeader.h"
+
+static const char CheckpointId[8] = "WSCCHKP";
+static const uint32_t CheckpointVersion = 1;
+
+/// FNV-1a hash, continued over the bytes of value
+template <class T> static void hashAdd(uint64_t& hash, const T& value) {
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+}
+
+/**
+ * hash of the network and the geometry, independent of flow direction:\n
+ * if it is equal the nodes, branches and tubes of the checkpoint are the same as in this model
+ */
+static uint64_t ModelHash() {
+	uint64_t hash = 14695981039346656037ull;
+	hashAdd(hash, Points.size());
+	hashAdd(hash, Tubes.size());
+	hashAdd(hash, Branches.size());
+	hashAdd(hash, Nodes.size());
+	for (const auto& iPoint : Points) {
+		hashAdd(hash, iPoint.xCoord);
+		hashAdd(hash, iPoint.yCoord);
+		hashAdd(hash, iPoint.zCoord);
+	}
+	for (const auto& iTube : Tubes) {
+		hashAdd(hash, min(iTube.PointIn, iTube.PointOut));
+		hashAdd(hash, max(iTube.PointIn, iTube.PointOut));
+		hashAdd(hash, iTube.Dia);
+		hashAdd(hash, iTube.Length);
+		hashAdd(hash, fabs(iTube.Height));
+		hashAdd(hash, iTube.RadiusBend);
+		hashAdd(hash, iTube.NoParallel);
+		hashAdd(hash, iTube.ksiAdd);
+		hashAdd(hash, fmin(iTube.DiaOrificeIn, iTube.DiaOrificeOut));
+		hashAdd(hash, fmax(iTube.DiaOrificeIn, iTube.DiaOrificeOut));
+		hashAdd(hash, iTube.NbBr);
+	}
+	for (const auto& iNode : Nodes) {
+		hashAdd(hash, iNode.NbPt);
+	}
+	return hash;
+}
+
+/**
+ * hash of the load case (drum data, heat, given enthalpies, calculation method):\n
+ * a checkpoint of another load case is still a good start, but not the solution
+ */
+static uint64_t LoadHash() {
+	uint64_t hash = 14695981039346656037ull;
+	hashAdd(hash, Drum.pMPa);
+	hashAdd(hash, Drum.LevelW);
+	hashAdd(hash, Drum.dpDyn);
+	hashAdd(hash, Base.Rough);
+	hashAdd(hash, Base.Method);
+	for (const auto& iTube : Tubes) {
+		hashAdd(hash, iTube.q);
+		hashAdd(hash, fabs(iTube.FactHeat - 1.));
+		hashAdd(hash, iTube.EnthInGiven);
+	}
+	return hash;
+}
+
+template <class T> static void put(ofstream& out, const T& value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T> static void get(ifstream& in, T& value) {
+	in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+int saveCheckpoint(const string& FileName) {
+	ofstream outData(FileName.c_str(), ios::binary);
+	if (!outData.good()) {
+		cout << "\n cannot open file " << FileName << endl;
+		throw _wscError("cannot open file " + FileName);
+	}
+	outData.write(CheckpointId, sizeof(CheckpointId));
+	put(outData, CheckpointVersion);
+	put(outData, ModelHash());
+	put(outData, LoadHash());
+	put(outData, static_cast<uint64_t>(Nodes.size()));
+	put(outData, static_cast<uint64_t>(Branches.size()));
+	put(outData, static_cast<uint64_t>(Tubes.size()));
+	put(outData, static_cast<int32_t>(Base.iterg));
+	for (const auto& iNode : Nodes) {
+		put(outData, iNode.pNode);
+		put(outData, iNode.pPrev);
+		put(outData, iNode.enth);
+		put(outData, iNode.gSteam);
+	}
+	/// the flow direction of a branch is given by its inlet point
+	for (const auto& iBranch : Branches) {
+		put(outData, static_cast<uint64_t>(iBranch.NbPtIn));
+		put(outData, iBranch.g);
+		put(outData, iBranch.gNew);
+		put(outData, iBranch.gPrev1);
+		put(outData, iBranch.gPrev2);
+		put(outData, iBranch.gPrev3);
+		put(outData, iBranch.enthIn);
+		put(outData, iBranch.enthOut);
+		put(outData, iBranch.xIn);
+		put(outData, iBranch.gSteamIn);
+		put(outData, iBranch.dPLinear);
+		put(outData, iBranch.dPConstant);
+		put(outData, static_cast<int32_t>(iBranch.neg));
+		put(outData, static_cast<int32_t>(iBranch.NoChanges));
+		put(outData, static_cast<uint8_t>(iBranch.isFlowSet2zero));
+		put(outData, static_cast<uint8_t>(iBranch.useTangent));
+	}
+	for (const auto& iTube : Tubes) {
+		put(outData, iTube.EnthIn);
+		put(outData, iTube.pPaIn);
+		put(outData, iTube.LengthStep);
+		put(outData, static_cast<int32_t>(iTube.NoSections));
+	}
+	outData.close();
+	return 0;
+}
+
+int readCheckpoint(const string& FileName) {
+	ifstream inData(FileName.c_str(), ios::binary);
+	if (!inData.good()) {
+		cout << "\n cannot open checkpoint " << FileName << ", using start values" << endl;
+		prot << "\n cannot open checkpoint " << FileName << ", using start values" << endl;
+		return 1;
+	}
+	char Id[sizeof(CheckpointId)] = {};
+	uint32_t Version = 0;
+	uint64_t Model = 0, Load = 0, NoNodes = 0, NoBranches = 0, NoTubes = 0;
+	int32_t iterg = 0;
+	inData.read(Id, sizeof(Id));
+	get(inData, Version);
+	get(inData, Model);
+	get(inData, Load);
+	get(inData, NoNodes);
+	get(inData, NoBranches);
+	get(inData, NoTubes);
+	get(inData, iterg);
+	/// a checkpoint of another version or another model is not used
+	if (!inData.good() || !equal(Id, Id + sizeof(Id), CheckpointId) || Version != CheckpointVersion) {
+		cout << "\n " << FileName << " is no checkpoint of this program version, using start values" << endl;
+		prot << "\n " << FileName << " is no checkpoint of this program version, using start values" << endl;
+		return 2;
+	}
+	if (Model != ModelHash() || NoNodes != Nodes.size() || NoBranches != Branches.size() || NoTubes != Tubes.size()) {
+		cout << "\n checkpoint " << FileName << " belongs to another model, using start values" << endl;
+		prot << "\n checkpoint " << FileName << " belongs to another model, using start values" << endl;
+		return 3;
+	}
+	vector<double> NodeData(4 * Nodes.size());
+	for (auto& value : NodeData) {
+		get(inData, value);
+	}
+	for (auto& iBranch : Branches) {
+		uint64_t NbPtIn;
+		int32_t neg, NoChanges;
+		uint8_t isFlowSet2zero, useTangent;
+		get(inData, NbPtIn);
+		if (NbPtIn != iBranch.NbPtIn) {
+			iBranch.reverseDirection();
+		}
+		get(inData, iBranch.g);
+		get(inData, iBranch.gNew);
+		get(inData, iBranch.gPrev1);
+		get(inData, iBranch.gPrev2);
+		get(inData, iBranch.gPrev3);
+		get(inData, iBranch.enthIn);
+		get(inData, iBranch.enthOut);
+		get(inData, iBranch.xIn);
+		get(inData, iBranch.gSteamIn);
+		get(inData, iBranch.dPLinear);
+		get(inData, iBranch.dPConstant);
+		get(inData, neg);
+		get(inData, NoChanges);
+		get(inData, isFlowSet2zero);
+		get(inData, useTangent);
+		iBranch.neg = neg;
+		iBranch.NoChanges = NoChanges;
+		iBranch.isFlowSet2zero = isFlowSet2zero != 0;
+		iBranch.useTangent = useTangent != 0;
+	}
+	for (auto& iTube : Tubes) {
+		int32_t NoSections;
+		get(inData, iTube.EnthIn);
+		get(inData, iTube.pPaIn);
+		get(inData, iTube.LengthStep);
+		get(inData, NoSections);
+		iTube.NoSections = NoSections;
+	}
+	if (!inData.good()) {
+		cout << "\n checkpoint " << FileName << " is incomplete" << endl;
+		prot << "\n checkpoint " << FileName << " is incomplete" << endl;
+		throw _wscError("checkpoint " + FileName + " is incomplete");
+	}
+	size_t iData = 0;
+	for (auto& iNode : Nodes) {
+		iNode.pNode = NodeData[iData++];
+		iNode.pPrev = NodeData[iData++];
+		iNode.enth = NodeData[iData++];
+		iNode.gSteam = NodeData[iData++];
+	}
+	prot << "\n start values from checkpoint " << FileName << " (iteration step " << iterg << ")";
+	if (Load != LoadHash()) {
+		prot << ", calculated for another load case";
+	}
+	prot << endl;
+	return 0;
+}
@@ -9,14 +9,14 @@
 //					alstar; ///<void fraction at CCFL 
 
 //Properties in British Units
-static double rhoF,///< density of fluid (water) (lbm/ft^3)
+static thread_local double rhoF,///< density of fluid (water) (lbm/ft^3)
 rhoG,///<density of gas (vapor,steam) (lbm/ft^3)
 sig,///<surface tension (lbf/ft) 
 rr,///<density ratio (-)
 cp;///<pressure factor (-)
 
 // constant values set once
-static double dh, ///<hydraulic diameter (ft) 
+static thread_local double dh, ///<hydraulic diameter (ft) 
 ReF,///<liquid Reynolds number  
 ReG,///<vapor Reynolds number  
 fra,///<tube orientation factor (-), tube orientation between 0 deg(vertical) and 90 deg (horizontal)  
@@ -27,7 +27,8 @@
 * @brief function to determine safety factor against different criteria
 *
 */
-void _tube::Criteria() {
+void _tube::Criteria(_circulationModel& Model) {
+	_activeModel Active(Model);
 	double  k, k1, k2, hf, hf1,
 		xCrit;
 	// checking for safety criteria
@@ -38,7 +39,8 @@ void _tube::Criteria() {
 	double enthWSat = H2O::enth(tSat, pMPa, WATER);
 	double enthSSat = H2O::enth(tSat, pMPa, STEAM);
 	double deltaEnthEvap = enthSSat - enthWSat;
-	SafetyFactor = 10.;
+	_tubeOutput& Out = TubesOutput[Number];
+	Out.SafetyFactor = 10.;
 	//   prot <<"pMPa "<<pMPa<< " q " << q << " HeatFlux " << HeatFlux  << " xOut " << xOut << endl;
 	/// only heated tubes are checked 
 	if (q > 1e-3 && xOut > 1.e-6 && xOut < 1.) {
@@ -63,18 +65,18 @@ void _tube::Criteria() {
 					VelWmin = VelWmin * (1. - 7.5e-3 * pMPa * 10.);
 				}
 			}
-			SafetyKorneev = VelW / VelWmin;
-			SafetyFactor = fmin(SafetyKorneev, SafetyFactor);
+			Out.SafetyKorneev = VelW / VelWmin;
+			Out.SafetyFactor = fmin(Out.SafetyKorneev, Out.SafetyFactor);
 
 // in horizontal heated tubes (angle to horizontal < 10 deg) the flow should not be stratified/wavy or mist
 			// Taitel-Dukler
 			if (fabs(Height / Length) < 0.17365) {//horizontal (< 10 deg)
-				SafetyTaitel_Dukler = Taitel_Dukler(pPaOut, xOut);
-				SafetyFactor = fmin(SafetyTaitel_Dukler, SafetyFactor);
+				Out.SafetyTaitel_Dukler = Taitel_Dukler(pPaOut, xOut);
+				Out.SafetyFactor = fmin(Out.SafetyTaitel_Dukler, Out.SafetyFactor);
 
 				// Steiner
-				SafetySteiner = Steiner(pPaOut, xOut);
-				SafetyFactor = fmin(SafetySteiner, SafetyFactor);
+				Out.SafetySteiner = Steiner(pPaOut, xOut);
+				Out.SafetyFactor = fmin(Out.SafetySteiner, Out.SafetyFactor);
 			}
 		}
 		else { // vertical tubes
@@ -97,8 +99,8 @@ void _tube::Criteria() {
 					xCrit = pow(HeatFlux, -.125) * 32.302 * pow(MassVel, -1. / 3.) *
 						pow(Dia * 1e3, -.07) * exp(pMPa * 10. * -.00795);
 				}		
-				SafetyKonkov = xCrit / xOut;
-				SafetyFactor = fmin(SafetyFactor, SafetyKonkov);
+				Out.SafetyKonkov = xCrit / xOut;
+				Out.SafetyFactor = fmin(Out.SafetyFactor, Out.SafetyKonkov);
 			}
 			/** for mass velocity > 500 and pressure > 2.9 MPa -> Film boiling according Doroshchuk */
 			if (MassVel >= 500. && (pMPa >= 2.9 && pMPa <= 20.) && (Dia >= .004
@@ -108,8 +110,8 @@ void _tube::Criteria() {
 				xCrit = (log(MassVel / 1e3) * (pred * .68 - .3) - log(HeatFlux * 1e3) + log(c)) /
 					(log(MassVel / 1e3) * 1.2 + 1.5);
 				if (xCrit > 0. && xCrit < 1.) {
-					SafetyDoroshchuk = xCrit / xOut;
-					SafetyFactor = fmin(SafetyFactor, SafetyDoroshchuk);
+					Out.SafetyDoroshchuk = xCrit / xOut;
+					Out.SafetyFactor = fmin(Out.SafetyFactor, Out.SafetyDoroshchuk);
 				}
 			}
 
@@ -169,14 +171,14 @@ void _tube::Criteria() {
 					}
 				}
 				xCrit = hf * (1. - k * xIn) * 4. * relLength + xIn;
-				SafetyKatto_Ohno = xCrit / xOut;
-				SafetyFactor = fmin(SafetyFactor,SafetyKatto_Ohno);
+				Out.SafetyKatto_Ohno = xCrit / xOut;
+				Out.SafetyFactor = fmin(Out.SafetyFactor,Out.SafetyKatto_Ohno);
 			}
 			/// 3) comparing to critical heat flux according to Groeneveld table
 			if (HeatFlux > 1.) {
 				//            prot << " chf " << chftable(pMPa, rhoW, rhoS) << " HeatFlux " << HeatFlux  << endl;
-				SafetyGroeneveld = chftable(pMPa, rhoWSat, rhoSSat) / HeatFlux;
-				SafetyFactor = fmin(SafetyGroeneveld, SafetyFactor);
+				Out.SafetyGroeneveld = chftable(pMPa, rhoWSat, rhoSSat) / HeatFlux;
+				Out.SafetyFactor = fmin(Out.SafetyGroeneveld, Out.SafetyFactor);
 			}
 		}
 	}
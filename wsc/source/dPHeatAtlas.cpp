@@ -32,7 +32,7 @@ double _tube::dpdyn_HeatAtlas(double pPaInSect, double pPaOutSect, double volSSa
 		 */
 		if (steiner == FlowPattern::mist) { //mist flow (calculated as steam flow, only steam portion regarded)
 			Reynolds = Dia * xMean * MassVel / (dynVisWSatIn + dynVisWSatOut) * 2.;
-			zeta = FrictFact(Reynolds, Base.Rough / Dia);
+			zeta = FrictFact(Reynolds, RelRough);
 			FrictCoeffTube = zeta * LengthSection / Dia;
 			if (Base.showDPTubeDetail) {
 				prot << "\n steiner = mist  reynolds " << Reynolds << " zeta " << zeta << " frictcoeff " << FrictCoeffTube;
@@ -136,7 +136,7 @@ double _tube::dpdyn_HeatAtlas(double pPaInSect, double pPaOutSect, double volSSa
 		 */
 		double MassVelW = MassVel * (1. - xMean);
 		Reynolds = Dia * MassVelW / (dynVisWSatIn + dynVisWSatOut) * 2.;
-		zeta = FrictFact(Reynolds, Base.Rough / Dia);
+		zeta = FrictFact(Reynolds, RelRough);
 		//				pBar = (pMPaIn + pMPaOut) * 5.;
 		double gamma = sqrt((1. / volWSatIn + 1. / volWSatOut) / (1. / volSSatIn + 1. / volSSatOut)) * pow((dynVisSSatIn + dynVisSSatOut) / (dynVisWSatIn + dynVisWSatOut), 0.1);
 		r1 = 1. + (gamma * gamma - 1.) * (21. / gamma * pow(xMean * (1. - xMean), 0.9) + pow(xMean, 1.8));
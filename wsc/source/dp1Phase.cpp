@@ -82,11 +82,11 @@ int _tube::dPSinglePhase(// returns error code: 0 all ok,
 		friction = FrictCoeff;
 		if (region == TbRegion::Tube) { //tube
 			Reynolds = Dia * MassVel / viscMean;
-			friction += FrictFact(Reynolds, Base.Rough / Dia) * LengthSection / Dia;
+			friction += FrictFact(Reynolds, RelRough) * LengthSection / Dia;
 			dpStatSect = 9.80665 * HeightSection / volMean;
 		}
 		else if (region == TbRegion::Orifice) { // orifice
-			friction = ksiOrifice(LengthOrifice, viscMean);
+			friction = ksiOrifice(LengthOrifice, viscMean, MassVel);
 		}
 		else if (region == TbRegion::Bend) { //bend
 			Reynolds = Dia * MassVel / viscMean;
@@ -128,12 +128,13 @@ int _tube::dPSinglePhase(// returns error code: 0 all ok,
 
 			prot << "\n pPaInSection = " << pPaInSect << " pPaOutSect = " << pPaOutSect;
 			prot << "\n dpDynSection = " << dpDynSect << " dpStatSection = " << dpStatSect;
-			exit(-1);
+			throw _wscError("tube " + to_string(Number) + " outlet pressure too low", -1);
 		}
 		tempOut = H2O::temp(enthOutSect, pMPaOut);
-		tSatOut = H2O::satTemp(pMPaOut);
-		enthWSatOut = H2O::enth(tSatOut, pMPaOut, WATER);
-		enthSSatOut = H2O::enth(tSatOut, pMPaOut, STEAM);
+		SaturationState SatOut = H2O::satState(pMPaOut);
+		tSatOut = SatOut.tSat;
+		enthWSatOut = SatOut.enthW;
+		enthSSatOut = SatOut.enthS;
 		/// checking for a phase change
 		if ((index == WATER && enthOutSect > enthWSatOut) ||
 			(index == STEAM && enthOutSect < enthSSatOut)) {
@@ -149,12 +150,36 @@ int _tube::dPSinglePhase(// returns error code: 0 all ok,
 			prot << "\n tube " << Number << " dP2phase iteration not converging ";
 			prot << "\n flow iteration step " << Base.iterg << "\n Branch " << NbBr << " Flow " << Flow;
 			cout << "\n tube " << Number << " dPTwoPhase iteration not converging ";
-			exit(-1);
+			throw _wscError("tube " + to_string(Number) + " dPSinglePhase iteration not converging", -1);
 		}
 	} while (fabs(pPaOutPrev / pPaInSect - pPaOutSect / pPaInSect) > 1.e-6);
 	rhoOutSect = 1. / volOut;
 	rhoMeanSect = 1. / volMean;
 	VelSect = MassVel * volMean;
+	/**
+	 * The derivative of the dynamic pressure difference with respect to the flow of all parallel tubes is added to dpDer (tangent of characteristic curve).\n
+	 * The properties are kept at the final values of the iteration, only mass velocity and Reynolds number depend on flow.\n
+	 * The resistance factors are evaluated once more with a _dual mass velocity, that gives value and exact derivative in one pass.
+	 */
+	if (isDpDerValid) {
+		if (PhaseChange) {
+			isDpDerValid = false;
+		}
+		else {
+			_dual MassVelD(MassVel, 1. / (area * NoParallel));
+			_dual frictionD = FrictCoeff;
+			if (region == TbRegion::Tube) {
+				frictionD += FrictFact(Dia * MassVelD / viscMean, RelRough) * LengthSection / Dia;
+			}
+			else if (region == TbRegion::Orifice) {
+				frictionD = ksiOrifice(LengthOrifice, viscMean, MassVelD);
+			}
+			else if (region == TbRegion::Bend) {
+				frictionD = ksiBend(Dia * MassVelD / viscMean, beta);
+			}
+			dpDer += (((volOut - volIn) + frictionD * volMean / 2.) * MassVelD * MassVelD).der;
+		}
+	}
 
 	return 0;
 }
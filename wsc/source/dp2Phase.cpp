@@ -5,7 +5,119 @@
 // It is assumed that the tube sections are small enough that the properties
 // are mean value between inlet and outlet
 
-int _tube::dPTwoPhase(
+/**
+ * calculation methods for 2-phase flow (Base.Method) as policy types\n
+ * Density: mixture density and void fraction at one end of the section\n
+ * dpDyn: dynamic pressure drop of a plain tube section\n
+ * the arguments are the same for all methods, each method takes what it needs
+ */
+struct JirousPolicy {
+	static double Density(_tube& Tube, double x, double pMPa, double volW, double volS,
+		double dynVisW, double dynVisS, double SurfTens, double& Void) {
+		return Tube.Density_Jirous(x, volW, volS, Void);
+	}
+	static double dpDyn(_tube& Tube, double zeta, double pMPaIn, double pMPaOut, double pPaIn, double pPaOut,
+		double volWIn, double volWOut, double volSIn, double volSOut, double enthWIn, double enthWOut,
+		double enthSIn, double enthSOut, double dynVisWIn, double dynVisWOut, double dynVisSIn, double dynVisSOut,
+		double xIn, double xOut) {
+		return Tube.dpdyn_Jirous(zeta, (pMPaIn + pMPaOut) / 2., volSIn, volSOut, volWIn, volWOut, (xIn + xOut) / 2.);
+	}
+};
+
+struct WelzerPolicy {
+	static double Density(_tube& Tube, double x, double pMPa, double volW, double volS,
+		double dynVisW, double dynVisS, double SurfTens, double& Void) {
+		return Tube.Density_Welzer(x, volW, volS, Void);
+	}
+	static double dpDyn(_tube& Tube, double zeta, double pMPaIn, double pMPaOut, double pPaIn, double pPaOut,
+		double volWIn, double volWOut, double volSIn, double volSOut, double enthWIn, double enthWOut,
+		double enthSIn, double enthSOut, double dynVisWIn, double dynVisWOut, double dynVisSIn, double dynVisSOut,
+		double xIn, double xOut) {
+		return Tube.dpdyn_Welzer(zeta, (volWIn + volWOut) / 2., (volSIn + volSOut) / 2.,
+			(enthWIn + enthWOut) / 2., (enthSIn + enthSOut) / 2., (dynVisWIn + dynVisWOut) / 2., xIn, xOut);
+	}
+};
+
+struct RouhaniBeckerPolicy {
+	static double Density(_tube& Tube, double x, double pMPa, double volW, double volS,
+		double dynVisW, double dynVisS, double SurfTens, double& Void) {
+		return Tube.Density_Rouhani(x, 1. / volW, 1. / volS, SurfTens, Void);
+	}
+	static double dpDyn(_tube& Tube, double zeta, double pMPaIn, double pMPaOut, double pPaIn, double pPaOut,
+		double volWIn, double volWOut, double volSIn, double volSOut, double enthWIn, double enthWOut,
+		double enthSIn, double enthSOut, double dynVisWIn, double dynVisWOut, double dynVisSIn, double dynVisSOut,
+		double xIn, double xOut) {
+		return Tube.dpdyn_Becker(zeta, xIn, xOut, pPaIn, pPaOut, volWIn, volWOut);
+	}
+};
+
+/// dynamic pressure drop according VDI Heat Atlas for the methods only giving the density
+struct HeatAtlasPolicy {
+	static double dpDyn(_tube& Tube, double zeta, double pMPaIn, double pMPaOut, double pPaIn, double pPaOut,
+		double volWIn, double volWOut, double volSIn, double volSOut, double enthWIn, double enthWOut,
+		double enthSIn, double enthSOut, double dynVisWIn, double dynVisWOut, double dynVisSIn, double dynVisSOut,
+		double xIn, double xOut) {
+		return Tube.dpdyn_HeatAtlas(pPaIn, pPaOut, volSIn, volSOut, volWIn, volWOut, dynVisWIn,
+			dynVisWOut, dynVisSIn, dynVisSOut, (xIn + xOut) / 2.);
+	}
+};
+
+struct ChexalHeatAtlasPolicy : HeatAtlasPolicy {
+	static double Density(_tube& Tube, double x, double pMPa, double volW, double volS,
+		double dynVisW, double dynVisS, double SurfTens, double& Void) {
+		return Tube.Density_chexal(x, pMPa, volW, volS, dynVisW, dynVisS, SurfTens, Void);
+	}
+};
+
+struct WoldesemayatPolicy : HeatAtlasPolicy {
+	static double Density(_tube& Tube, double x, double pMPa, double volW, double volS,
+		double dynVisW, double dynVisS, double SurfTens, double& Void) {
+		return Tube.Density_Woldesemayat(x, 1. / volW, 1. / volS, SurfTens, pMPa, Void);
+	}
+};
+
+/// sets the instance of dPTwoPhaseMethod for Base.Method in the active model
+void SelectTwoPhaseMethod() {
+	auto& TwoPhaseKernel = ActiveModel->TwoPhaseKernel;
+	switch (Base.Method) {
+	case 'J':
+		TwoPhaseKernel = &_tube::dPTwoPhaseMethod<JirousPolicy>;
+		break;
+	case 'W':
+		TwoPhaseKernel = &_tube::dPTwoPhaseMethod<WelzerPolicy>;
+		break;
+	case 'R':
+		TwoPhaseKernel = &_tube::dPTwoPhaseMethod<RouhaniBeckerPolicy>;
+		break;
+	case 'E':
+		TwoPhaseKernel = &_tube::dPTwoPhaseMethod<ChexalHeatAtlasPolicy>;
+		break;
+	case 'G':
+		TwoPhaseKernel = &_tube::dPTwoPhaseMethod<WoldesemayatPolicy>;
+		break;
+	default:
+		prot << "\n error: calculation method for 2-phase flow " << Base.Method << " unknown (J, W, R, E, G)" << endl;
+		cout << "\n error: calculation method for 2-phase flow " << Base.Method << " unknown (J, W, R, E, G)" << endl;
+		throw _wscError(string("calculation method for 2-phase flow ") + Base.Method + " unknown");
+	}
+}
+
+int _tube::dPTwoPhase(TbRegion region, double FrictCoeffAdd, double enthIn, double enthOut, double LengthOrifice,
+	bool& PhaseChange, double& tSatOut, double& volWSatOut, double& volSSatOut, double& SurfTensOut,
+	double& dynVisSSatOut, double& dynVisWSatOut, double& enthWSatOut, double& enthSSatOut,
+	double& pPaOutSect, double& dpDynSect, double& dpStatSect, double& xInSect, double& xOutSect,
+	double& rhoInSect, double& rhoOutSect, double& VoidInSect, double& VoidOutSect,
+	double& rhoMeanSect, double& VelSect)
+{
+	return (this->*ActiveModel->TwoPhaseKernel)(region, FrictCoeffAdd, enthIn, enthOut, LengthOrifice,
+		PhaseChange, tSatOut, volWSatOut, volSSatOut, SurfTensOut,
+		dynVisSSatOut, dynVisWSatOut, enthWSatOut, enthSSatOut,
+		pPaOutSect, dpDynSect, dpStatSect, xInSect, xOutSect,
+		rhoInSect, rhoOutSect, VoidInSect, VoidOutSect, rhoMeanSect, VelSect);
+}
+
+template <class Method>
+int _tube::dPTwoPhaseMethod(
 	TbRegion region, // single place is default but FrictCoeffAdd must be given, orifice, bend, tube
 	//        double pPaInSect, // absolute pressure at inlet [Pa]
 	double FrictCoeffAdd, //friction coefficient [-]
@@ -73,23 +185,24 @@ int _tube::dPTwoPhase(
 	pPaInSect = pPaOutSect;
 	pMPaIn = pPaInSect * 1e-6;
 	if (rhoOutSect < 1e-3) { // calculate conditions at inlet
-		tSatIn = H2O::satTemp(pMPaIn);
+		SaturationState SatIn = H2O::satState(pMPaIn);
+		tSatIn = SatIn.tSat;
 		tSatOut = tSatIn;
-		volSSatIn = H2O::specVol(tSatIn, pMPaIn, STEAM);
+		volSSatIn = SatIn.volS;
 		volSSatOut = volSSatIn;
-		volWSatIn = H2O::specVol(tSatIn, pMPaIn, WATER);
+		volWSatIn = SatIn.volW;
 		volWSatOut = volWSatIn;
 		rhoWSatIn = 1. / volWSatIn;
 		rhoSSatIn = 1. / volSSatIn;
-		SurfTensIn = H2O::sigma(tSatIn) / 1000.;
+		SurfTensIn = SatIn.SurfTens;
 		SurfTensOut = SurfTensIn;
-		dynVisSSatIn = H2O::dynVisc(tSatIn, volSSatIn);
+		dynVisSSatIn = SatIn.dynVisS;
 		dynVisSSatOut = dynVisSSatIn;
-		dynVisWSatIn = H2O::dynVisc(tSatIn, volWSatIn);
+		dynVisWSatIn = SatIn.dynVisW;
 		dynVisWSatOut = dynVisWSatIn;
-		enthWSatIn = H2O::enth(tSatIn, pMPaIn, WATER);
+		enthWSatIn = SatIn.enthW;
 		enthWSatOut = enthWSatIn;
-		enthSSatIn = H2O::enth(tSatIn, pMPaIn, STEAM);
+		enthSSatIn = SatIn.enthS;
 		enthSSatOut = enthSSatIn;
 		xInSect = (enthIn - enthWSatIn) / (enthSSatIn - enthWSatIn);
 		if (Base.showDPTubeDetail) {
@@ -115,26 +228,8 @@ int _tube::dPTwoPhase(
 				if (Base.showDPTubeDetail) {
 					prot << "\n row 113 xInSect " << xInSect << endl;
 				}
-				switch (Base.Method) {
-				case 'J':
-					rhoInSect = Density_Jirous(xInSect, volWSatIn, volSSatIn, VoidInSect);
-					break;
-				case 'W':
-					rhoInSect = Density_Welzer(xInSect, volWSatIn, volSSatIn, VoidInSect);
-					break;
-				case 'R':
-					rhoInSect = Density_Rouhani(xInSect, rhoWSatIn, rhoSSatIn, SurfTensIn, VoidInSect);
-					break;
-				case 'C':
-					//                rhoOutSect = density_chawla();
-					break;
-				case 'E':
-					rhoInSect = Density_chexal(xInSect, pMPaIn, volWSatIn, volSSatIn,
-						dynVisWSatIn, dynVisSSatIn, SurfTensIn, VoidInSect);
-					break;
-				case 'G':
-					rhoOutSect = Density_Woldesemayat(xInSect, rhoWSatIn, rhoSSatIn, SurfTensIn, pMPaIn, VoidInSect);
-				}
+				rhoInSect = Method::Density(*this, xInSect, pMPaIn, volWSatIn, volSSatIn,
+					dynVisWSatIn, dynVisSSatIn, SurfTensIn, VoidInSect);
 				if (rhoInSect < rhoSSatIn || rhoInSect > rhoWSatIn) {
 					return 1;
 				}
@@ -200,26 +295,8 @@ int _tube::dPTwoPhase(
 			}
 			else {
 				//            cout << "\n192 xout " << xOutSect << " pMPa " << pMPaOut;
-				switch (Base.Method) {
-				case 'J':
-					rhoOutSect = Density_Jirous(xOutSect, volWSatOut, volSSatOut, VoidOutSect);
-					break;
-				case 'W':
-					rhoOutSect = Density_Welzer(xOutSect, volWSatOut, volSSatOut, VoidOutSect);
-					break;
-				case 'R':
-					rhoOutSect = Density_Rouhani(xOutSect, 1. / volWSatOut, 1. / volSSatOut, SurfTensOut, VoidOutSect);
-					break;
-				case 'C':
-					//               rhoOutSect = density_chawla();
-					break;
-				case 'E':
-					rhoOutSect = Density_chexal(xOutSect, pMPaOut, volWSatOut, volSSatOut,
-						dynVisWSatOut, dynVisSSatOut, SurfTensOut, VoidOutSect);
-					break;
-				case 'G':
-					rhoOutSect = Density_Woldesemayat(xOutSect, 1. / volWSatOut, 1. / volSSatOut, SurfTensOut, pMPaOut, VoidOutSect);
-				}
+				rhoOutSect = Method::Density(*this, xOutSect, pMPaOut, volWSatOut, volSSatOut,
+					dynVisWSatOut, dynVisSSatOut, SurfTensOut, VoidOutSect);
 			}
 		}
 		xMean = (xInSect + xOutSect) / 2.;
@@ -237,29 +314,11 @@ int _tube::dPTwoPhase(
 			rhoMeanSect = (rhoInSect + rhoOutSect) / 2.;
 			dpStatSect = rhoMeanSect * 9.80665 * HeightSection;
 			Reynolds = Dia * MassVel / (dynVisWSatIn + dynVisWSatOut) * 2.;
-			zeta = FrictFact(Reynolds, Base.Rough / Dia);
-			switch (Base.Method) {
-			case 'J':
-				dpDynSect = dpdyn_Jirous(zeta, (pMPaIn + pMPaOut) / 2., volSSatIn, volSSatOut, volWSatIn, volWSatOut, xMean);
-				break;
-			case 'W':
-				dpDynSect = dpdyn_Welzer(zeta, (volWSatIn + volWSatOut) / 2., (volSSatIn + volSSatOut) / 2.,
-					(enthWSatIn + enthWSatOut) / 2., (enthSSatIn + enthSSatOut) / 2.,
-					(dynVisWSatIn + dynVisWSatOut) / 2., xInSect, xOutSect);
-				break;
-			case 'R':
-				dpDynSect = dpdyn_Becker(zeta, xInSect, xOutSect, pPaInSect, pPaOutSect,
-					volWSatIn, volWSatOut);
-				break;
-			case 'C':
-				//    dpDynSect =      rhoOutSect = density_chawla();
-				break;
-			case 'E':
-			case 'G':
-				dpDynSect = dpdyn_HeatAtlas(pPaInSect, pPaOutSect, volSSatIn,
-					volSSatOut, volWSatIn, volWSatOut, dynVisWSatIn,
-					dynVisWSatOut, dynVisSSatIn, dynVisSSatOut, xMean);
-			}
+			zeta = FrictFact(Reynolds, RelRough);
+			dpDynSect = Method::dpDyn(*this, zeta, pMPaIn, pMPaOut, pPaInSect, pPaOutSect,
+				volWSatIn, volWSatOut, volSSatIn, volSSatOut, enthWSatIn, enthWSatOut,
+				enthSSatIn, enthSSatOut, dynVisWSatIn, dynVisWSatOut, dynVisSSatIn, dynVisSSatOut,
+				xInSect, xOutSect);
 			if (Base.showDPTubeDetail) {
 				prot << "\n frictCoeffAdd " << FrictCoeffAdd << " rhoIn " << rhoInSect << " rhoOut " << rhoOutSect;
 				prot << "\n 1/volWin " << 1. / volWSatIn << " 1/volWout " << 1. / volWSatOut << " MassVel " << MassVel;
@@ -268,7 +327,7 @@ int _tube::dPTwoPhase(
 			break;
 		case TbRegion::Orifice: //orifice region
 			dynVisOut = H2O::dynVisc(tSatOut, 1. / rhoOutSect);
-			FrictCoeffAdd = ksiOrifice(LengthOrifice, (dynVisIn + dynVisOut) / 2.);
+			FrictCoeffAdd = ksiOrifice(LengthOrifice, (dynVisIn + dynVisOut) / 2., MassVel);
 			if (Base.showDPTubeDetail) {
 				prot << "\n orifice dynVisIn " << dynVisIn << " dynVisOut " << dynVisOut;
 				prot << "\n friction orifice " << FrictCoeffAdd << endl;
@@ -328,21 +387,22 @@ int _tube::dPTwoPhase(
 			prot << "\n pPaInSection = " << pPaInSect << " pPaOutSect = " << pPaOutSect;
 			prot << "\n dpDynSection = " << dpDynSect << " dpStatSection = " << dpStatSect;
 
-			exit(-1);
+			throw _wscError("tube " + to_string(Number) + " outlet pressure too low", -1);
 		}
 		//      cout << "\n region " << region << " dpdyn " << dpDynSect << " dpstat " << dpStatSect << " frict " << FrictCoeffAdd;
 		if (Base.showDPTubeDetail) {
 			prot << "\n dpdyn " << dpDynSect << " dpstat " << dpStatSect;
 			prot << "\n pPaIn " << pPaInSect << " pPaOutSect " << pPaOutSect;
 		}
-		tSatOut = H2O::satTemp(pMPaOut);
-		volWSatOut = H2O::specVol(tSatOut, pMPaOut, WATER);
-		volSSatOut = H2O::specVol(tSatOut, pMPaOut, STEAM);
-		SurfTensOut = H2O::sigma(tSatOut) / 1000.;
-		dynVisSSatOut = H2O::dynVisc(tSatOut, volSSatOut);
-		dynVisWSatOut = H2O::dynVisc(tSatOut, volWSatOut);
-		enthWSatOut = H2O::enth(tSatOut, pMPaOut, WATER);
-		enthSSatOut = H2O::enth(tSatOut, pMPaOut, STEAM);
+		SaturationState SatOut = H2O::satState(pMPaOut);
+		tSatOut = SatOut.tSat;
+		volWSatOut = SatOut.volW;
+		volSSatOut = SatOut.volS;
+		SurfTensOut = SatOut.SurfTens;
+		dynVisSSatOut = SatOut.dynVisS;
+		dynVisWSatOut = SatOut.dynVisW;
+		enthWSatOut = SatOut.enthW;
+		enthSSatOut = SatOut.enthS;
 		//      cout << "\n dpdyn " << dpDynSect << " dpstat " << dpStatSect << " pPaOut " << pPaOutSect << " tsat " << tSatOut;
 		xOutSect = (enthOut - enthWSatOut) / (enthSSatOut - enthWSatOut);
 		if (Base.showDPTubeDetail) {
@@ -365,7 +425,7 @@ int _tube::dPTwoPhase(
 				prot << "\n one possible reason can be a sharp edged bend (radius = 0) and a Reynolds number close to 40 000 Reynold = " << Reynolds<<endl ;
 			}
 			cout << "\n tube " << Number << " dPTwoPhase iteration not converging ";
-			exit(-1);
+			throw _wscError("tube " + to_string(Number) + " dPTwoPhase iteration not converging", -1);
 		}
 		//     double bla = fabs(pPaOutSect / pPaInSect - pPrev / pPaInSect);
 	} while (fabs(pPaOutSect / pPaInSect - pPrev / pPaInSect) > 1e-8);
@@ -16,8 +16,11 @@
 //#include "stdafx.h"
 #undef MAINFUNCTION
 #include "CommonHeader.h"
+#include <algorithm>
+#include <exception>
 
-int _branch::dpBranch() {
+int _branch::dpBranch(_circulationModel& Model) {
+	_activeModel Active(Model);
 	/* Local variables */
 	size_t PtTbIn,
 		PtTbOut,
@@ -37,7 +40,6 @@ int _branch::dpBranch() {
 		gf1 = 0.,
 		gf2 = 0.,
 		gf3 = 0.,
-		gOriginal = 0.,
 		betaIn = 0.,
 		gcalc = 0.,
 		g1 = 0.,
@@ -45,42 +47,48 @@ int _branch::dpBranch() {
 		dPdyn2 = 0.,
 		dPdyn1 = 0.,
 		dPstat2 = 0.,
-		dPstat1 = 0.;
+		dPstat1 = 0.,
+		dPTangent = 0.; // derivative of pressure difference with respect to flow
+	bool isTangentValid = false;
 	//		dpIn1,		dpIn2, dpOut1, dpOut2,
-	bool isZero = false;
 
+	/**
+	 * The flow of the branch is copied to gBr, the calculation only uses this copy.\n
+	 * the flow g of this branch is read by neighbouring branches (Tee junctions) and has to stay unchanged, also when the branches are calculated in parallel
+	 */
+	double gBr = g;
 	if (Base.iterg == 1 && g / minArea < 0.1) {
 		/**
 		 * --------
 		 *  In the first flow iteration step it can happen that the flow is ~0 but we need some flow for the approximate characteristic curve.
 		 */
-		gOriginal = g;
 		if (fabs(deltaH) > 0.1) {
-			g = 300. * minArea; /// in vertical branches set maximum mass velocity = 300
+			gBr = 300. * minArea; /// in vertical branches set maximum mass velocity = 300
 		}
 		else {
 			/**
 			 * In horizontal branches (mostly in headers in the middle between 2 supply pipes or connections to drum)\n
 			 * the flow is close to 0. A low starting value is used in this case: mass velocity = 50 \n
 			 */
-			g = 50. * minArea;
+			gBr = 50. * minArea;
 		}
-		isZero = true;
 		/**
-		 * This flow is only used for the first approximate characteristic curve and reset later.\n
+		 * This flow is only used for the first approximate characteristic curve.\n
 		 *
 		 *  -----------
 		 */
 	}
 	// prot << "\nmassvel " << g/minArea <<    endl;
-	if (g / minArea > 0.1) { /// No calculation if max. mass velocity less than 0.1 the data from last flow iteration step are kept
-		gf1 = gPrev1 / g;
-		gf2 = gPrev2 / g;
-		gf3 = gPrev3 / g;
+	if (gBr / minArea > 0.1) { /// No calculation if max. mass velocity less than 0.1 the data from last flow iteration step are kept
+		gf1 = gPrev1 / gBr;
+		gf2 = gPrev2 / gBr;
+		gf3 = gPrev3 / gBr;
 		/**
-		 * Looping 3 times through the calculation for 3 flows to determine factors of approximate characteristic curve.
+		 * Looping 3 times through the calculation for 3 flows to determine factors of approximate characteristic curve.\n
+		 * If the tangent can be used, only the last calculation with the actual flow is done and the derivative is calculated alongside.
 		 */
-		for (int iz = 1; iz <= 3; ++iz) {
+		int izFirst = useTangent ? 3 : 1;
+		for (int iz = izFirst; iz <= 3; ++iz) {
 			switch (iz) {
 			case 1:
 				/**
@@ -111,11 +119,13 @@ int _branch::dpBranch() {
 				*/
 				gfact = 1.;
 			}
-			gcalc = gfact * g;
+			gcalc = gfact * gBr;
 			dPIn = 0.;
 			dPOut = 0.;
 			dPdyn = 0.;
 			dPstat = 0.;
+			dPTangent = 0.;
+			isTangentValid = gSteamIn < 1e-6; // inlet enthalpy depends on flow, if steam enters the branch
 			iTbPrev = MINUS1;
 			/**
 			 * Iterating through all tubes in this branch to calculate the pressure difference
@@ -234,10 +244,8 @@ int _branch::dpBranch() {
 						}
 						else {
 							double pMPaIn = iTube->pPaIn * 1e-6;
-							double tSatIn = H2O::satTemp(pMPaIn);
-							double enthWSatIn = H2O::enth(tSatIn, pMPaIn, WATER);
-							double enthSSatIn = H2O::enth(tSatIn, pMPaIn, STEAM);
-							iTube->EnthIn = gSteamIn / gcalc * (enthSSatIn - enthWSatIn) + enthWSatIn;
+							SaturationState SatIn = H2O::satState(pMPaIn);
+							iTube->EnthIn = gSteamIn / gcalc * (SatIn.enthS - SatIn.enthW) + SatIn.enthW;
 						}
 						if (NodeIn->mBrInNd == 1) { // this can only happen if one branch is set to zero
 															 // mBrInNd is index, the actual number of branches in this node is 2   
@@ -268,8 +276,8 @@ int _branch::dpBranch() {
 										Branches[iBr1].NbNdOut == NbNdIn) {
 										// union of flow 1 and 0
 										//	OffUnionInletOff
-										angle = fmax(Tubes[NodeIn->NbTbTStraight[0]].Angle3d(*iTube),
-											Tubes[NodeIn->NbTbTStraight[1]].Angle3d(*iTube));
+										angle = fmax(NodeIn->AngleTee(Tubes[NodeIn->NbTbTStraight[0]], *iTube),
+											NodeIn->AngleTee(Tubes[NodeIn->NbTbTStraight[1]], *iTube));
 										ksiIn = KsiTee(TFlow::OffUnionInletOff, 1.,
 											1., 1., 1., 1., 1.0, 1.);
 										if (Base.showDPBranch) {
@@ -285,10 +293,11 @@ int _branch::dpBranch() {
 										gz = (Branches[iBr1].g * gfact + gcalc) / iTubez->NoParallel;
 										// make sure that total flow is bigger than flow in off branch
 										/**
-										 * Angle between "straight" branch and "off" branch has to be calculated each time, angle other than 90deg\n
-										 * change depending on flow direction in "straight" branch
+										 * Angle between "straight" branch and "off" branch has to be taken each time, angle other than 90deg\n
+										 * change depending on flow direction in "straight" branch (both cases are set in isTee)
 										 */
-										angle = iTubez->Angle3d(*iTube);
+										angle = NodeIn->AngleTee(*iTubez, *iTube);
+										isTangentValid = false; // resistance factor depends on flow
 										ksiIn = KsiTee(TFlow::StraightSeparationInletOff, gz,
 											gcalc / iTube->NoParallel, iTubez->area,
 											iTube->area, 0, angle, iTube->Dia);
@@ -304,7 +313,8 @@ int _branch::dpBranch() {
 										iTubez = &Tubes[NodeIn->NbTbTStraight[1]];
 										gz = (Branches[iBr0].g * gfact + gcalc) / iTubez->NoParallel;
 										//make sure that total flow is bigger than flow in off branch
-										angle = iTubez->Angle3d(*iTube);
+										angle = NodeIn->AngleTee(*iTubez, *iTube);
+										isTangentValid = false; // resistance factor depends on flow
 										ksiIn = KsiTee(TFlow::StraightSeparationInletOff, gz,
 											gcalc / iTube->NoParallel, iTubez->area,
 											iTube->area, 0, angle, iTube->Dia);
@@ -317,14 +327,15 @@ int _branch::dpBranch() {
 								else { // inlet in straight tube
 									if (Branches[iBrOff].NbNdIn == NbNdIn) { /// inlet in straight tube at flow separation
 										iTubeOff = &Tubes[NodeIn->NbTbTOff];
-										angle = iTubeOff->Angle3d(*iTube);
+										angle = NodeIn->AngleTee(*iTubeOff, *iTube);
 										//                             if (Number == iBr0) {
 										iTubez = &Tubes[NodeIn->NbTbTStraight[1]];
 										/*   } else */ if (Number == iBr1) {
 											iTubez = &Tubes[NodeIn->NbTbTStraight[0]];
 										}
 										// make sure that total flow is bigger than flow in off branch
-										gz = (Branches[iBrOff].g + g) / iTubez->NoParallel;
+										gz = (Branches[iBrOff].g + gBr) / iTubez->NoParallel;
+										isTangentValid = false; // resistance factor depends on flow
 										ksiIn = KsiTee(TFlow::StraightSeparationInletStraight, gz,
 											Branches[iBrOff].g / iTubeOff->NoParallel,
 											iTubez->area, iTubeOff->area, 0, angle,
@@ -347,7 +358,7 @@ int _branch::dpBranch() {
 											Branches[iBr1].NbNdIn == NbNdIn) { // outlet of iBrOff separates to iBr0 and iBr1
 									 //  OffSeparationInletStraight
 											iTubeOff = &Tubes[NodeIn->NbTbTOff];
-											angle = iTubeOff->Angle3d(*iTube);
+											angle = NodeIn->AngleTee(*iTubeOff, *iTube);
 											ksiIn = KsiTee(TFlow::OffSeparationInletStraight, 1., 1., 1., 1.,
 												1., angle, 1.);
 											if (Base.showDPBranch) {
@@ -385,6 +396,7 @@ int _branch::dpBranch() {
 							iTube->beta > 10. && 
 							Tubes[iTbPrev].Dia < MinDrumDiameter) { // iTbPrev is header but in one Branch
 					 // is handled like Tee with full flow in off tube
+							isTangentValid = false; // resistance factor depends on flow
 							ksiIn = KsiTee(TFlow::StraightSeparationInletOff,
 								gcalc / Tubes[iTbPrev].NoParallel,
 								gcalc / iTube->NoParallel, Tubes[iTbPrev].area,
@@ -405,6 +417,7 @@ int _branch::dpBranch() {
 					 // is handled like Tee with full flow in incoming tube
 					 // a bit tricky: the pressure drop is taken as outlet of previous
 					 // but calculated as inlet loss of this tube
+							isTangentValid = false; // resistance factor depends on flow
 							ksiIn = KsiTee(TFlow::StraightUnionOutletOff,
 								gcalc / iTube->NoParallel,
 								gcalc / Tubes[iTbPrev].NoParallel, iTube->area,
@@ -468,12 +481,13 @@ int _branch::dpBranch() {
 										// main flow from iBr0 to iBr1, union from iBrOff
 										iTubez = &Tubes[NodeOut->NbTbTStraight[1]];
 										//make sure that total flow is bigger than flow in off branch
-										gz = (Branches[iBr0].g + g) / iTubez->NoParallel;
+										gz = (Branches[iBr0].g + gBr) / iTubez->NoParallel;
 										//										prot << "\n1 is z g.ibr0 " << Branches[iBr0].g << " g.iBr1 "
 										//											<< Branches[iBr1].g << " g " << g << " gz " << gz;
 										// angle has to be calculated each time, angle other than 90 deg
 										// change depending on flow in main branch
-										angle = iTubez->Angle3d(*iTube);
+										angle = NodeOut->AngleTee(*iTubez, *iTube);
+										isTangentValid = false; // resistance factor depends on flow
 										ksiOut = KsiTee(TFlow::StraightUnionOutletOff, gz,
 											gcalc / iTube->NoParallel, iTubez->area,
 											iTube->area, 0, angle, iTube->Dia);
@@ -488,10 +502,11 @@ int _branch::dpBranch() {
 										//  main flow from iBr1 to iBr0, union from iBrOff
 										iTubez = &Tubes[NodeOut->NbTbTStraight[0]];
 										//make sure that total flow is bigger than flow in off branch
-										gz = (Branches[iBr1].g + g) / iTubez->NoParallel;
+										gz = (Branches[iBr1].g + gBr) / iTubez->NoParallel;
 										//										prot << "\n0 is z g.ibr0 " << Branches[iBr0].g << " g.iBr1 "
 										//											<< Branches[iBr1].g << " g " << g << " gz " << gz;
-										angle = iTubez->Angle3d(*iTube);
+										angle = NodeOut->AngleTee(*iTubez, *iTube);
+										isTangentValid = false; // resistance factor depends on flow
 										ksiOut = KsiTee(TFlow::StraightUnionOutletOff, gz,
 											gcalc / iTube->NoParallel, iTubez->area,
 											iTube->area, 0, angle, iTube->Dia);
@@ -528,7 +543,7 @@ int _branch::dpBranch() {
 											NbNdOut == Branches[iBr0].NbNdOut &&
 											NbNdOut == Branches[iBrOff].NbNdIn)) {
 										iTubez = &Tubes[NodeOut->NbTbTStraight[0]];
-										angle = iTubez->Angle3d(*iTube);
+										angle = NodeOut->AngleTee(*iTubez, *iTube);
 										ksiOut = KsiTee(TFlow::OffUnionOutletStraight, 1., 1., 1.,
 											1., 0., angle, 1.);
 										if (Base.showDPBranch) {
@@ -539,7 +554,7 @@ int _branch::dpBranch() {
 									else {
 										iTubeOff = &Tubes[NodeOut->NbTbTOff];
 										if (Branches[iBrOff].NbNdOut == NbNdOut) {
-											angle = iTubeOff->Angle3d(*iTube);
+											angle = NodeOut->AngleTee(*iTubeOff, *iTube);
 											//if (Number == iBr0) {
 											iTubez = &Tubes[NodeOut->NbTbTStraight[1]];
 											/*} else */if (Number == iBr1) {
@@ -547,6 +562,7 @@ int _branch::dpBranch() {
 											}
 											//make sure that total flow is bigger than flow in off branch
 											gz = (Branches[iBrOff].g * gfact + gcalc) / iTubez->NoParallel;
+											isTangentValid = false; // resistance factor depends on flow
 											ksiOut = KsiTee(TFlow::StraightUnionOutletStraight, gz,
 												Branches[iBrOff].g * gfact / iTubeOff->NoParallel,
 												iTubez->area, iTubeOff->area, 0, angle,
@@ -567,10 +583,12 @@ int _branch::dpBranch() {
 				  * The number of sections are determined for the lowest flow (highest enthalpy difference)
 				  */
 
-					if (iz == 1) {
+					if (iz == izFirst) {
 						iTube->DetermineNoSections(gcalc);
 					}
-					iTube->dpTube(ksiIn, ksiOut, gcalc);
+					iTube->dpTube(Model, ksiIn, ksiOut, gcalc);
+					dPTangent += iTube->dpDer;
+					if (!iTube->isDpDerValid) isTangentValid = false;
 					//               iTube->pPaOut = iTube->pPaIn - iTube->dpdyn -
 					//               iTube->dpstat - iTube->dpIn - iTube->dpOut;
 					if (iTbInBr == 0) dPIn = iTube->dpIn;
@@ -603,27 +621,179 @@ int _branch::dpBranch() {
 			case 3:
 				break;
 			}
+			/**
+			 * If the tangent is not valid (heated or two-phase tube, flow dependent Tee resistance) the secant is used for this branch from now on.\n
+			 * The calculation restarts with the first of the 3 flows.
+			 */
+			if (izFirst == 3 && !isTangentValid) {
+				useTangent = false;
+				izFirst = 1;
+				iz = 0;
+			}
 		} // end of loop for the 3 flows
  /**
-  * 6) All 3 flows are handled and dPLinear and dPConstant are determined.
+  * 6) All flows are handled and dPLinear and dPConstant are determined.
   */
-		dPLinear = (dPdyn2 + dPstat2 - dPdyn1 - dPstat1) / (g2 - g1);
-		dPConstant = (dPdyn + dPstat) - g * dPLinear;
+		if (useTangent) {
+			dPLinear = dPTangent;
+		}
+		else {
+			dPLinear = (dPdyn2 + dPstat2 - dPdyn1 - dPstat1) / (g2 - g1);
+		}
+		dPConstant = (dPdyn + dPstat) - gBr * dPLinear;
 
 	} //else { // max. mass velocity < 0.1
 		// the factors, pressure drop, outlet pressure etc. is kept from previous step
 //   }
 	if (Base.showDPBranch) {
 		double dPtotal = dPdyn + dPstat;
-		prot << "\nBranch : " << Number << " g =  " << g << " dPdyn = " << dPdyn
+		prot << "\nBranch : " << Number << " g =  " << gBr << " dPdyn = " << dPdyn
 			<< " dPstat = " << dPstat;
 		prot << "\ndPtotal " << dPtotal << " dynLin " << dPLinear << " dPConstant "
-			<< dPConstant;
+			<< dPConstant << (useTangent ? " tangent" : " secant");
 	}
-	if (isZero) {
-		// Flow is ~0, but we needed some flow for the characteristic curve ->has to be set back
-		g = gOriginal;
-	}
-
 	return 0;
 } /* dpBranch */
+
+/**
+ * \brief calculation of pressure difference in all branches
+ *
+ * dpBranch only changes the branch itself and its tubes, flows of other branches are only read\n
+ * therefore the branches can be calculated in parallel\n
+ * the branches with most work (number of sections in all tubes of last step) are started first, the others fill the gaps (dynamic schedule)\n
+ * protocol output of each branch is collected in a buffer and written in order of the branches afterwards\n
+ * the threads work on the model active in the calling thread; an error in one branch (_wscError) is passed on after all threads have finished
+ * \param skipZeroFlow true: branches with flow set to zero are not calculated (iteration), false: all branches (final results)
+ * \param skipUnchanged true: branches whose inputs changed less than Base.SkipTol since their last calculation are not calculated again
+ */
+void dpAllBranches(bool skipZeroFlow, bool skipUnchanged) {
+	static thread_local vector<size_t> Order;
+	static thread_local vector<double> Work;
+	_circulationModel& Model = *ActiveModel;
+	exception_ptr Error = nullptr;
+	atomic<bool> isFailed(false); // after an error the remaining branches are not calculated
+	vector<string> BranchProt(mBr + 1);
+	Order.resize(mBr + 1);
+	Work.resize(mBr + 1);
+	for (const auto& iBranch : Branches) {
+		double Sections = 0.;
+		for (const auto& iTb : iBranch.NbTbInBr) {
+			Sections += Tubes[iTb].NoSections + 2.; // +2 for inlet and outlet
+		}
+		Work[iBranch.Number] = Sections;
+		Order[iBranch.Number] = iBranch.Number;
+	}
+	std::stable_sort(Order.begin(), Order.end(), [](size_t a, size_t b) { return Work[a] > Work[b]; });
+
+	int NoBr = static_cast<int> (mBr + 1);
+	int NoCalc = 0;
+	int NoSkipped = 0;
+	skipUnchanged = skipUnchanged && Base.SkipTol > 0.;
+#pragma omp parallel
+	{
+		_activeModel Active(Model);
+		ostringstream ThreadProt;
+		prot.setBuffer(&ThreadProt);
+#pragma omp for schedule(dynamic, 1) reduction(+:NoCalc, NoSkipped)
+		for (int i = 0; i < NoBr; i++) {
+			if (isFailed) continue;
+			_branch& iBranch = Branches[Order[i]];
+			if (Base.showDPBranch) {
+				prot << "\n\n   *************";
+				prot << "\n   * Branch # " << iBranch.Number << endl;
+			}
+			if (skipZeroFlow && iBranch.isFlowSet2zero) {
+				if (Base.showDPBranch) {
+					prot << "\n Flow is set to 0 " << endl;
+				}
+			}
+			else {
+				++NoCalc;
+				if (skipUnchanged && iBranch.isLastCalcValid &&
+					iBranch.Inputs().isClose(iBranch.InputsLastCalc, Base.SkipTol)) {
+					++NoSkipped;
+					if (Base.showDPBranch) {
+						prot << "\n inputs unchanged, calculation of last step is kept" << endl;
+					}
+				}
+				else {
+					try {
+						iBranch.dpBranch(Model);
+						// taken after the calculation, dpBranch can increase the number of sections
+						iBranch.InputsLastCalc = iBranch.Inputs();
+						iBranch.isLastCalcValid = true;
+					}
+					catch (...) {
+#pragma omp critical(dpAllBranchesError)
+						if (!isFailed) {
+							Error = current_exception();
+							isFailed = true;
+						}
+					}
+				}
+			}
+			BranchProt[iBranch.Number] = ThreadProt.str();
+			ThreadProt.str("");
+		}
+		prot.setBuffer(nullptr);
+	}
+	for (const auto& Text : BranchProt) {
+		if (!Text.empty()) prot << Text;
+	}
+	if (Error != nullptr) rethrow_exception(Error);
+	if (skipUnchanged) {
+		prot << "\n iteration " << Base.iterg << " branches unchanged " << NoSkipped << " of " << NoCalc
+			<< " (" << (NoCalc > 0 ? 100. * NoSkipped / NoCalc : 0.) << " %)" << endl;
+	}
+	return;
+}
+
+_branchInputs _branch::Inputs() const {
+	_branchInputs Actual;
+	const _node& NodeIn = Nodes[NbNdIn];
+	const _node& NodeOut = Nodes[NbNdOut];
+	Actual.g = g;
+	Actual.pIn = NodeIn.pNode + Drum.pMPa * 1e6;
+	Actual.pOut = NodeOut.pNode + Drum.pMPa * 1e6;
+	Actual.enthIn = enthIn;
+	Actual.gSteamIn = gSteamIn;
+	Actual.NbNdIn = NbNdIn;
+	Actual.mBrInNdIn = NodeIn.mBrInNd;
+	Actual.mBrInNdOut = NodeOut.mBrInNd;
+	// the resistance of a Tee depends on flow and direction in the other branches of the Tee
+	int iTee = 0;
+	for (const _node* Node : { &NodeIn, &NodeOut }) {
+		if (Node->IsT) {
+			for (size_t iBr : { Node->NbBrTStraight[0], Node->NbBrTStraight[1], Node->NbBrTOff }) {
+				const _branch& TeeBranch = Branches[iBr];
+				Actual.gTee[iTee] = TeeBranch.NbNdIn == Node->Number ? TeeBranch.g : -TeeBranch.g;
+				iTee++;
+			}
+		}
+		else {
+			iTee += 3;
+		}
+	}
+	for (const auto& iTb : NbTbInBr) {
+		Actual.NoSections += Tubes[iTb].NoSections;
+	}
+	return Actual;
+}
+
+bool _branchInputs::isClose(const _branchInputs& other, double tol) const {
+	auto close = [tol](double a, double b) {
+		return fabs(a - b) <= tol * fmax(fabs(a), fabs(b));
+	};
+	if (NbNdIn != other.NbNdIn || mBrInNdIn != other.mBrInNdIn || mBrInNdOut != other.mBrInNdOut ||
+		NoSections != other.NoSections) {
+		return false;
+	}
+	if (!close(g, other.g) || !close(pIn, other.pIn) || !close(pOut, other.pOut) ||
+		!close(enthIn, other.enthIn) || !close(gSteamIn, other.gSteamIn)) {
+		return false;
+	}
+	for (int iTee = 0; iTee < 6; ++iTee) {
+		if (!close(gTee[iTee], other.gTee[iTee])) return false;
+	}
+	return true;
+}
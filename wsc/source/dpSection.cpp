@@ -58,9 +58,10 @@ int _tube::dPSection(// returns error code: 0 all ok, 1 phase change, 2 out of t
 		enthWSatOutSect < 1. ||
 		enthSSatOutSect < 1.) {
 		pMPaIn = pPaInSect * 1e-6;
-		tSatIn = H2O::satTemp(pMPaIn);
-		enthWSatInSect = H2O::enth(tSatIn, pMPaIn, WATER);
-		enthSSatInSect = H2O::enth(tSatIn, pMPaIn, STEAM);
+		SaturationState SatIn = H2O::satState(pMPaIn);
+		tSatIn = SatIn.tSat;
+		enthWSatInSect = SatIn.enthW;
+		enthSSatInSect = SatIn.enthS;
 	}
 	else {
 		enthWSatInSect = enthWSatOutSect;
@@ -129,6 +130,7 @@ int _tube::dPSection(// returns error code: 0 all ok, 1 phase change, 2 out of t
 		}
 	}
 	else { //two-phase flow
+		isDpDerValid = false; // no derivative for two-phase flow, secant has to be used
 		error = dPTwoPhase(region, FrictCoeff,
 			enthInSect, enthOutSect, LengthOrifice, PhaseChange,
 			tSatOutSect, volWOutSect, volSOutSect, SurfTensOutSect, dynVisSOutSect,
@@ -0,0 +1,93 @@
+//#include "stdafx.h"
+#include "CommonHeader.h"
+/* ----------------------------------------------------------------------- */
+/*   straight part of a tube, the section length follows an error estimate */
+/* ----------------------------------------------------------------------- */
+
+bool _tube::isSectioned() const {
+	return (RadiusBend < 1e-3 && Length / Dia > 2.) ||
+		(RadiusBend > 1e-3 && RadiusBend / Dia > 5.);
+}
+
+int _tube::dPSectionLength(_sectionState& Sect, double LengthSect) {
+	LengthSection = LengthSect;
+	HeightSection = Height * LengthSect / Length;
+	HeatSection = q / NoParallel * LengthSect / Length;
+	Sect.enthInSect = Sect.enthOutSect;
+	Sect.enthOutSect += HeatSection / Flow;
+	return dPSection(TbRegion::Tube, // tube
+		ksiAdd * LengthSect / Length, // additional friction coefficient in proportion to length
+		Sect.enthInSect, Sect.enthOutSect, 0., Sect.PhaseChange,
+		Sect.tSatOutSect, Sect.volWOutSect, Sect.volSOutSect, Sect.SurfTensOutSect,
+		Sect.dynVisSOutSect, Sect.dynVisWOutSect, Sect.dynVisOutSect,
+		Sect.enthWSatOutSect, Sect.enthSSatOutSect, Sect.pPaOutSect,
+		Sect.dpDynSect, Sect.dpStatSect, Sect.xInSect, Sect.xOutSect,
+		Sect.rhoInSect, Sect.rhoOutSect, Sect.VoidInSect, Sect.VoidOutSect,
+		Sect.rhoMeanSect, Sect.VelSect);
+}
+
+int _tube::dpSectionsAdaptive(_sectionState& Sect) {
+	int error = 0;
+	// the members describe the sections of DetermineNoSections() again after the integration
+	double LengthSectionFixed = LengthSection;
+	double HeightSectionFixed = HeightSection;
+	double HeatSectionFixed = HeatSection;
+	/// as in DetermineNoSections() a section should not be shorter than the diameter
+	double LengthMin = fmin(Dia, Length);
+	/// the first step starts with the proposal of the last calculation, if there is none with the section length of DetermineNoSections()
+	double Step = LengthStep > 0. ? LengthStep : LengthSection;
+	double LengthDone = 0.;
+	NoStepsAdaptive = 0;
+	while (Length - LengthDone > 1e-6) {
+		double StepTaken = fmin(Step, Length - LengthDone);
+		// the derivative is added up by the sections, only the accepted ones count
+		double dpDerStart = dpDer;
+		bool isDpDerValidStart = isDpDerValid;
+		_sectionState Full = Sect;
+		dPSectionLength(Full, StepTaken);
+		dpDer = dpDerStart;
+		isDpDerValid = isDpDerValidStart;
+		_sectionState Half1 = Sect;
+		dPSectionLength(Half1, StepTaken / 2.);
+		_sectionState Half2 = Half1;
+		error = dPSectionLength(Half2, StepTaken / 2.);
+		/**
+		 * the error of the step is estimated by the difference of outlet pressure between one section and two sections of half length,\n
+		 * the allowed error is in proportion to the step length, so the whole tube stays within Base.DpTol
+		 */
+		double ErrorStep = fabs(Full.pPaOutSect - Half2.pPaOutSect);
+		double ErrorAllowed = Base.DpTol * StepTaken / Length;
+		if (Base.showDPTube) {
+			prot << "\n adaptive step " << StepTaken << " error " << ErrorStep << " allowed " << ErrorAllowed;
+		}
+		if (ErrorStep > ErrorAllowed && StepTaken > 2. * LengthMin) {
+			/// rejected step: calculated again with shorter length
+			dpDer = dpDerStart;
+			isDpDerValid = isDpDerValidStart;
+			Step = fmax(StepTaken * fmax(0.2, 0.9 * cbrt(ErrorAllowed / ErrorStep)), LengthMin);
+			continue;
+		}
+		for (const _sectionState* Half : { &Half1, &Half2 }) {
+			dpdyn += Half->dpDynSect;
+			dpstat += Half->dpStatSect;
+			if (NoStepsAdaptive == 0 && rhoIn < 1.) {
+				rhoIn = Half->rhoInSect;
+				xIn = Half->xInSect;
+				VoidFractionIn = Half->VoidInSect;
+			}
+			ksiTube += Half->dpDynSect * 2. * Half->rhoMeanSect / MassVel / MassVel;
+			++NoStepsAdaptive;
+		}
+		Sect = Half2;
+		LengthDone += StepTaken;
+		/// the next step length follows the error, the local error of a section is of third order in length
+		double StepProposed = ErrorStep > 0. ? StepTaken * fmin(2., 0.9 * cbrt(ErrorAllowed / ErrorStep)) : 2. * StepTaken;
+		// a step shortened to the end of the tube does not reduce the proposal
+		Step = fmin(StepTaken < Step ? fmax(Step, StepProposed) : StepProposed, Length);
+	}
+	LengthStep = Step;
+	LengthSection = LengthSectionFixed;
+	HeightSection = HeightSectionFixed;
+	HeatSection = HeatSectionFixed;
+	return error;
+}
@@ -5,12 +5,14 @@
 /*
 *  calculates the pressure difference in a tube
 *
+*  Model model the tube belongs to
 *  ResFactIn resistance factor at inlet [-]
 *  ResFactOut resistance factor at outlet [-]
 *  g Flow in all parallel tubes [kg/s]
 * return int error code
 */
-int _tube::dpTube(double ResFactIn, double ResFactOut, double g) {
+int _tube::dpTube(_circulationModel& Model, double ResFactIn, double ResFactOut, double g) {
+	_activeModel Active(Model);
 	int error = 0;
 	double rhoInSect = 0.; // density at inlet [kg/m3]
 	double rhoOutSect = 0.; // density at outlet [kg/m3]
@@ -48,6 +50,12 @@ int _tube::dpTube(double ResFactIn, double ResFactOut, double g) {
 	dpstat = 0.;
 	dpIn = 0.;
 	dpOut = 0.;
+	/**
+	 * the derivative of the pressure difference with respect to flow is only valid for unheated tubes,\n
+	 * in heated tubes the enthalpy and therefore density and static pressure difference depend on flow
+	 */
+	dpDer = 0.;
+	isDpDerValid = fabs(HeatSection) * NoSections < 1e-3;
 	// calculation of inlet
 	enthInSect = EnthIn;
 	pPaOutSect = pPaIn;
@@ -226,63 +234,108 @@ int _tube::dpTube(double ResFactIn, double ResFactOut, double g) {
 	/**
 	* 4) loop through sections and calculate pressure difference of tube without inlet and outlet
 	*/
-	FrictCoeffAdd = ksiAdd / NoSections;
-	for (int i = 1; i <= NoSections; ++i) {
-		enthInSect = enthOutSect;
-		enthOutSect += HeatSection / Flow;
-		if (Base.showDPTube) {
-			prot << "\n Tube Section " << i << " NoSections " << NoSections;
-		}
-		//cout<< " Tube Section " << i<<endl;
-		error = dPSection(TbRegion::Tube, // single place (inlet, outlet,orifice, valve) or tube = 0
-			FrictCoeffAdd, //friction coefficient [-]
-			// if single place: friction coefficient of this particular place
-			// if tube: additional friction coefficient
-			enthInSect, // inlet enthalpy [kJ/kg]
-			enthOutSect, // outlet enthalpy [kJ/kg]
-			0., // length (thickness) of orifice [m]
-			PhaseChange,
-			tSatOutSect, //saturation temperature at outlet [K]
-			volWOutSect, //spec. volume of saturated water at outlet  [m3/kg]
-			volSOutSect, //spec. volume of saturated steam at outlet [m3/kg]
-			SurfTensOutSect, //surface tension at outlet [N/m]
-			dynVisSOutSect, // dynamic viscosity of saturated steam at outlet [Pa s]
-			dynVisWOutSect, //dynamic viscosity of saturated water at outlet [Pa s]
-			dynVisOutSect, //dynamic viscosity at outlet [Pa s], single phase
-			enthWSatOutSect, //spec. enthalpy of saturated water at outlet [kJ/kg]
-			enthSSatOutSect, //spec. enthalpy of saturated steam at outlet [kJ/kg]
-			pPaOutSect, // absolute pressure at outlet [Pa]
-			dpDynSect, // dynamic pressure drop [Pa]
-			dpStatSect, // static pressure difference [Pa]
-			xInSect, //steam quality at inlet
-			xOutSect, //steam quality at outlet
-			rhoInSect, // density at inlet [kg/m3]
-			rhoOutSect, // density at outlet [kg/m3]
-			// if no previous section, it has to be 0.
-			VoidInSect, // void fraction at inlet
-			VoidOutSect, // void fraction at outlet 
-			rhoMeanSect, // mean density [kg/m3]
-			VelSect); // mean velocity [m/s]
-		if (Base.showDPTube) {
-			prot << "\n section: dpDynSect " << dpDynSect << " dpStatSect " << dpStatSect;
-			prot << "\n rhooutsect" << rhoOutSect << " vel " << MassVel / rhoOutSect;
-			prot << "\n PPaOutSect " << pPaOutSect << " voidOut " << VoidOutSect;
-		}
-		dpdyn += dpDynSect;
-		dpstat += dpStatSect;
-		if (i == 1 && rhoIn < 1.) {
-			rhoIn = rhoInSect;
-			xIn = xInSect;
-			VoidFractionIn = VoidInSect;
-		}
+	bool isSectionsDone = false;
+	if ((Base.DpTol > 0. || Base.WaterFastTol > 0.) && isSectioned()) {
+		_sectionState Sect = { enthInSect, enthOutSect, PhaseChange, tSatOutSect, volWOutSect, volSOutSect,
+			SurfTensOutSect, dynVisSOutSect, dynVisWOutSect, dynVisOutSect, enthWSatOutSect, enthSSatOutSect,
+			pPaOutSect, dpDynSect, dpStatSect, xInSect, xOutSect, rhoInSect, rhoOutSect,
+			VoidInSect, VoidOutSect, rhoMeanSect, VelSect };
 		/**
-		 * ksiTube is added up over all sections
+		 * unheated tubes with subcooled water can be calculated in closed form (dpWaterClosedForm)\n
+		 * with a tolerance Base.DpTol the section length is controlled by an error estimate (dpSectionsAdaptive)
 		 */
-		ksiTube += dpDynSect * 2. * rhoMeanSect / MassVel / MassVel;
-		if (Base.showDPTube) {
-			prot << "\n tube: dpDyn " << dpdyn << " dpStat " << dpstat;
+		if (Base.WaterFastTol > 0. && fabs(q) < 1e-3 && dpWaterClosedForm(Sect)) {
+			isSectionsDone = true;
+		}
+		else if (Base.DpTol > 0.) {
+			error = dpSectionsAdaptive(Sect);
+			isSectionsDone = true;
+		}
+		if (isSectionsDone) {
+			enthInSect = Sect.enthInSect;
+			enthOutSect = Sect.enthOutSect;
+			PhaseChange = Sect.PhaseChange;
+			tSatOutSect = Sect.tSatOutSect;
+			volWOutSect = Sect.volWOutSect;
+			volSOutSect = Sect.volSOutSect;
+			SurfTensOutSect = Sect.SurfTensOutSect;
+			dynVisSOutSect = Sect.dynVisSOutSect;
+			dynVisWOutSect = Sect.dynVisWOutSect;
+			dynVisOutSect = Sect.dynVisOutSect;
+			enthWSatOutSect = Sect.enthWSatOutSect;
+			enthSSatOutSect = Sect.enthSSatOutSect;
+			pPaOutSect = Sect.pPaOutSect;
+			dpDynSect = Sect.dpDynSect;
+			dpStatSect = Sect.dpStatSect;
+			xInSect = Sect.xInSect;
+			xOutSect = Sect.xOutSect;
+			rhoInSect = Sect.rhoInSect;
+			rhoOutSect = Sect.rhoOutSect;
+			VoidInSect = Sect.VoidInSect;
+			VoidOutSect = Sect.VoidOutSect;
+			rhoMeanSect = Sect.rhoMeanSect;
+			VelSect = Sect.VelSect;
 		}
+	}
+	if (!isSectionsDone) {
+		FrictCoeffAdd = ksiAdd / NoSections;
+		for (int i = 1; i <= NoSections; ++i) {
+			enthInSect = enthOutSect;
+			enthOutSect += HeatSection / Flow;
+			if (Base.showDPTube) {
+				prot << "\n Tube Section " << i << " NoSections " << NoSections;
+			}
+			//cout<< " Tube Section " << i<<endl;
+			error = dPSection(TbRegion::Tube, // single place (inlet, outlet,orifice, valve) or tube = 0
+				FrictCoeffAdd, //friction coefficient [-]
+				// if single place: friction coefficient of this particular place
+				// if tube: additional friction coefficient
+				enthInSect, // inlet enthalpy [kJ/kg]
+				enthOutSect, // outlet enthalpy [kJ/kg]
+				0., // length (thickness) of orifice [m]
+				PhaseChange,
+				tSatOutSect, //saturation temperature at outlet [K]
+				volWOutSect, //spec. volume of saturated water at outlet  [m3/kg]
+				volSOutSect, //spec. volume of saturated steam at outlet [m3/kg]
+				SurfTensOutSect, //surface tension at outlet [N/m]
+				dynVisSOutSect, // dynamic viscosity of saturated steam at outlet [Pa s]
+				dynVisWOutSect, //dynamic viscosity of saturated water at outlet [Pa s]
+				dynVisOutSect, //dynamic viscosity at outlet [Pa s], single phase
+				enthWSatOutSect, //spec. enthalpy of saturated water at outlet [kJ/kg]
+				enthSSatOutSect, //spec. enthalpy of saturated steam at outlet [kJ/kg]
+				pPaOutSect, // absolute pressure at outlet [Pa]
+				dpDynSect, // dynamic pressure drop [Pa]
+				dpStatSect, // static pressure difference [Pa]
+				xInSect, //steam quality at inlet
+				xOutSect, //steam quality at outlet
+				rhoInSect, // density at inlet [kg/m3]
+				rhoOutSect, // density at outlet [kg/m3]
+				// if no previous section, it has to be 0.
+				VoidInSect, // void fraction at inlet
+				VoidOutSect, // void fraction at outlet 
+				rhoMeanSect, // mean density [kg/m3]
+				VelSect); // mean velocity [m/s]
+			if (Base.showDPTube) {
+				prot << "\n section: dpDynSect " << dpDynSect << " dpStatSect " << dpStatSect;
+				prot << "\n rhooutsect" << rhoOutSect << " vel " << MassVel / rhoOutSect;
+				prot << "\n PPaOutSect " << pPaOutSect << " voidOut " << VoidOutSect;
+			}
+			dpdyn += dpDynSect;
+			dpstat += dpStatSect;
+			if (i == 1 && rhoIn < 1.) {
+				rhoIn = rhoInSect;
+				xIn = xInSect;
+				VoidFractionIn = VoidInSect;
+			}
+			/**
+			 * ksiTube is added up over all sections
+			 */
+			ksiTube += dpDynSect * 2. * rhoMeanSect / MassVel / MassVel;
+			if (Base.showDPTube) {
+				prot << "\n tube: dpDyn " << dpdyn << " dpStat " << dpstat;
+			}
 
+		}
 	}
 	/**
 	 * 5) if there is an orifice at outlet adding the pressure loss
@@ -0,0 +1,99 @@
+//#include "stdafx.h"
+#include "CommonHeader.h"
+/* ----------------------------------------------------------------------- */
+/*   unheated tube with single phase water: pressure difference in closed  */
+/*   form for the whole straight part                                     */
+/* ----------------------------------------------------------------------- */
+
+bool _tube::dpWaterClosedForm(_sectionState& Sect) {
+	if (Sect.PhaseChange) return false;
+	const double dpMPaDiff = 0.01; // pressure step for derivative of spec. volume [MPa]
+	double pPaInTube = Sect.pPaOutSect;
+	double pMPaIn = pPaInTube * 1e-6;
+	double enth = Sect.enthOutSect;
+	/// only for subcooled water at inlet
+	if (enth > H2O::satState(pMPaIn).enthW - 1e-3) return false;
+	/**
+	 * properties at inlet, taken from the preceding region if there is one (as in dPSinglePhase)\n
+	 * the spec. volume is linearised in pressure at constant enthalpy: vol = volIn + dVoldp * (p - pIn),\n
+	 * the viscosity is kept constant
+	 */
+	double volIn, dynVisc;
+	if (Sect.rhoOutSect < 1. || Sect.dynVisOutSect > 1. || Sect.dynVisOutSect <= 0.) {
+		double tempIn = H2O::temp(enth, pMPaIn);
+		volIn = H2O::specVol(tempIn, pMPaIn, WATER);
+		dynVisc = H2O::dynVisc(tempIn, volIn);
+	}
+	else {
+		volIn = 1. / Sect.rhoOutSect;
+		dynVisc = Sect.dynVisOutSect;
+	}
+	// the derivative is taken towards higher pressure, the water is more subcooled there
+	double pMPaDiff = pMPaIn + dpMPaDiff;
+	double volDiff = H2O::specVol(H2O::temp(enth, pMPaDiff), pMPaDiff, WATER);
+	double dVoldp = (volDiff - volIn) / (dpMPaDiff * 1e6); // [m3/kg Pa]
+	/**
+	 * with vol(out) = volIn - dVoldp * dp and volMean = volIn - dVoldp * dp / 2 the pressure difference dp solves\n
+	 * dp = (-dVoldp * dp + friction * volMean / 2) * MassVel^2 + g * Height / volMean\n
+	 * starting from constant volume a single Newton step is enough, the change of volume is very small
+	 */
+	double MassVel2 = MassVel * MassVel;
+	double friction = ksiAdd + FrictFact(Dia * MassVel / dynVisc, RelRough) * Length / Dia;
+	double dp = friction * volIn / 2. * MassVel2 + 9.80665 * Height / volIn;
+	double volMean = volIn - dVoldp * dp / 2.;
+	double residual = dp - (-dVoldp * dp + friction * volMean / 2.) * MassVel2 - 9.80665 * Height / volMean;
+	double slope = 1. + dVoldp * MassVel2 + friction * dVoldp * MassVel2 / 4.
+		- 9.80665 * Height * dVoldp / (2. * volMean * volMean);
+	dp -= residual / slope;
+	/// the closed form is used only if the pressure changes less than Base.WaterFastTol (relative to inlet pressure)
+	if (fabs(dp) > Base.WaterFastTol * pPaInTube) return false;
+	double pPaOutTube = pPaInTube - dp;
+	double pMPaOut = pPaOutTube * 1e-6;
+	SaturationState SatOut = H2O::satState(pMPaOut);
+	/// and if the water is still subcooled at outlet
+	if (enth > SatOut.enthW - 1e-3) return false;
+
+	double volOut = volIn - dVoldp * dp;
+	volMean = (volIn + volOut) / 2.;
+	Sect.enthInSect = enth;
+	Sect.tSatOutSect = SatOut.tSat;
+	Sect.volWOutSect = SatOut.volW;
+	Sect.volSOutSect = SatOut.volS;
+	Sect.SurfTensOutSect = SatOut.SurfTens;
+	Sect.dynVisSOutSect = SatOut.dynVisS;
+	Sect.dynVisWOutSect = SatOut.dynVisW;
+	Sect.dynVisOutSect = dynVisc;
+	Sect.enthWSatOutSect = SatOut.enthW;
+	Sect.enthSSatOutSect = SatOut.enthS;
+	Sect.pPaOutSect = pPaOutTube;
+	Sect.dpStatSect = 9.80665 * Height / volMean;
+	Sect.dpDynSect = dp - Sect.dpStatSect;
+	Sect.xInSect = 0.;
+	Sect.xOutSect = 0.;
+	Sect.rhoInSect = 1. / volIn;
+	Sect.rhoOutSect = 1. / volOut;
+	Sect.VoidInSect = 0.;
+	Sect.VoidOutSect = 0.;
+	Sect.rhoMeanSect = 1. / volMean;
+	Sect.VelSect = MassVel * volMean;
+
+	dpdyn += Sect.dpDynSect;
+	dpstat += Sect.dpStatSect;
+	if (rhoIn < 1.) {
+		rhoIn = Sect.rhoInSect;
+		xIn = 0.;
+		VoidFractionIn = 0.;
+	}
+	ksiTube += Sect.dpDynSect * 2. * Sect.rhoMeanSect / MassVel2;
+	/// derivative with respect to flow with properties kept constant, as in dPSinglePhase
+	if (isDpDerValid) {
+		_dual MassVelD(MassVel, 1. / (area * NoParallel));
+		_dual frictionD = ksiAdd + FrictFact(Dia * MassVelD / dynVisc, RelRough) * Length / Dia;
+		dpDer += (((volOut - volIn) + frictionD * volMean / 2.) * MassVelD * MassVelD).der;
+	}
+	NoStepsAdaptive = 1;
+	if (Base.showDPTube) {
+		prot << "\n closed form water: dpDyn " << Sect.dpDynSect << " dpStat " << Sect.dpStatSect << " PPaOut " << pPaOutTube;
+	}
+	return true;
+}
@@ -659,36 +659,88 @@ void printVisitedVertices(const vector<VertexInfo>& Vertices, size_t iNode) {
 }
 
 /**
- * \fn void put_into(list<size_t>& sorted, const vector<VertexInfo>& Vertices, size_t iVx, double weight)
- * \brief puts iVx (node number) into sorted list and keep it sorted according weight with lowest weight at beginning of list
+ * \class VertexHeap
+ * \brief temporary vertices (node numbers) of the shortest distance search sorted according weight, lowest weight on top
  *
- * \param sorted: list of indexes (iVx, node number)
- * \param Vertices: vector of all Vertices
- * \param iVx: index = node number
- * \param weight: weight of Vertex iVx
+ * indexed binary heap: inserting and lowering the weight of a vertex already in the heap (decrease-key) is O(log n)\n
+ * vertices with equal weight are taken in order of their (last) insertion, the same order as a sorted list with insertion behind equal weights
  */
-void put_into(list<size_t>& sorted, const vector<VertexInfo>& Vertices, size_t iVx, double weight) {
+class VertexHeap {
+public:
+	/// prepares the heap for vertices 0 .. NoVx - 1
+	void resize(size_t NoVx) {
+		Pos.assign(NoVx, MINUS1);
+		Heap.clear();
+	}
+	bool empty() const { return Heap.empty(); }
+	/// removes all vertices
+	void clear() {
+		for (const auto& iEntry : Heap) Pos[iEntry.iVx] = MINUS1;
+		Heap.clear();
+	}
 	/**
-	 * -# if list empty put it in
-	 * -# if iVx is already in list, it might be at the wrong position -> remove it
-	 * -# iterate through list\n
-	 *    if weight of list element is higher than weight, insert the iVx at this place
-	 * -# if no place found to insert, put at end of list
+	 * \brief puts iVx into heap or changes its weight if it is already in
+	 * \param iVx: index = node number
+	 * \param weight: weight of Vertex iVx
 	 */
-	if (sorted.empty()) {
-		sorted.push_back(iVx);
-		return;
-	}
-	sorted.remove(iVx);
-	for (auto iter = sorted.begin(); iter != sorted.end(); iter++) {
-		if (Vertices[*iter].weight > weight) {
-			iter = sorted.insert(iter, iVx);
-			return;
+	void put(size_t iVx, double weight) {
+		size_t i = Pos[iVx];
+		if (i == MINUS1) {
+			i = Heap.size();
+			Heap.push_back({ weight, Seq++, iVx });
+		}
+		else {
+			Heap[i] = { weight, Seq++, iVx };
 		}
+		siftDown(siftUp(i));
 	}
-	sorted.push_back(iVx);
-	return;
-}
+	/// removes and returns the vertex with lowest weight
+	size_t pop() {
+		size_t iVx = Heap[0].iVx;
+		Pos[iVx] = MINUS1;
+		Heap[0] = Heap.back();
+		Heap.pop_back();
+		if (!Heap.empty()) siftDown(0);
+		return iVx;
+	}
+private:
+	struct Entry {
+		double weight; ///< weight of vertex
+		size_t seq;    ///< insertion count, breaks ties of equal weights
+		size_t iVx;    ///< index = node number
+	};
+	vector<Entry> Heap;
+	stVector Pos; ///< position of vertex in Heap, MINUS1 if not in heap
+	size_t Seq = 0;
+
+	static bool isBefore(const Entry& a, const Entry& b) {
+		return a.weight < b.weight || (a.weight == b.weight && a.seq < b.seq);
+	}
+	size_t siftUp(size_t i) {
+		while (i > 0) {
+			size_t parent = (i - 1) / 2;
+			if (!isBefore(Heap[i], Heap[parent])) break;
+			swap(Heap[i], Heap[parent]);
+			Pos[Heap[i].iVx] = i;
+			i = parent;
+		}
+		Pos[Heap[i].iVx] = i;
+		return i;
+	}
+	void siftDown(size_t i) {
+		size_t n = Heap.size();
+		while (true) {
+			size_t child = 2 * i + 1;
+			if (child >= n) break;
+			if (child + 1 < n && isBefore(Heap[child + 1], Heap[child])) child++;
+			if (!isBefore(Heap[child], Heap[i])) break;
+			swap(Heap[i], Heap[child]);
+			Pos[Heap[i].iVx] = i;
+			i = child;
+		}
+		Pos[Heap[i].iVx] = i;
+	}
+};
 #if 0
 /*
 * \fn void remove_one(list<size_t>& theList, const size_t number)
@@ -726,7 +778,7 @@ void initialize_Vertices(vector<VertexInfo>& Vertices) {
  * \brief process node at other end of branch
  *
  * \param Vertices: vector of Vertices
- * \param tempVx: list of temporary Vertices
+ * \param tempVx: heap of temporary Vertices
  * \param iBr: branch number
  * \param iNd: node number of starting node
  * \param NodalFlow: Flow at root of tree
@@ -734,7 +786,7 @@ void initialize_Vertices(vector<VertexInfo>& Vertices) {
  * \param minWeightTarget: minimum weight of target
  * \return size_t index of other node
  */
-size_t process_OtherNode(vector<VertexInfo>& Vertices, list<size_t>& tempVx,
+size_t process_OtherNode(vector<VertexInfo>& Vertices, VertexHeap& tempVx,
 	const size_t& iBr, const size_t& iNd, const double NodalFlow,
 	const double R, const double minWeightTarget) {
 	/**
@@ -745,7 +797,7 @@ size_t process_OtherNode(vector<VertexInfo>& Vertices, list<size_t>& tempVx,
 	 *
 	 * the new weight is compared to already minimum weight of other node\n
 	 * if it is lower the data of the node (weight, NbNdPrev, NbBr) is replaced\n
-	 * and it is put at the right place in the sorted list tempVx
+	 * and it is put at the right place in the heap tempVx
 	 */
 	size_t otherNode = Branches[iBr].NbNdOut;
 	if (iNd == otherNode) otherNode = Branches[iBr].NbNdIn;
@@ -760,7 +812,7 @@ size_t process_OtherNode(vector<VertexInfo>& Vertices, list<size_t>& tempVx,
 		if (Vertices[otherNode].weight > Weight) {
 			Vertices[otherNode].NbNdPrev = iNd;
 			Vertices[otherNode].NbBr = iBr;
-			put_into(tempVx, Vertices, otherNode, Weight);
+			tempVx.put(otherNode, Weight);
 			Vertices[otherNode].weight = Weight;
 			return otherNode;
 		}
@@ -842,7 +894,8 @@ void initFlow() {
 	vector<bool> isBrDirectionSet(mBr + 1, false);
 
 	vector<VertexInfo> Vertices(mNd + 1);
-	list<size_t> tempVx;
+	VertexHeap tempVx;
+	tempVx.resize(mNd + 1);
 	//	VertexInfo PaVx;
 	size_t iNdTarget;
 	list<int> PathNodes;
@@ -969,16 +1022,15 @@ void initFlow() {
 			prot << "\nroot " << iNodeDowncomerIn;
 		}
 		initialize_Vertices(Vertices);
-		tempVx.push_back(iNodeDowncomerIn);
+		tempVx.put(iNodeDowncomerIn, 0.);
 		Vertices[iNodeDowncomerIn].weight = 0.;
 		while (!tempVx.empty()) {
-			iNd = tempVx.front();
-			tempVx.pop_front();
+			iNd = tempVx.pop();
 			if (Base.showMeshDetail) {
 				prot << "\n---------------------------------------------------------------------------------------\n";
 			}
 			if (iNd != DRUM) { //iNd is drum -> already target
-				for (size_t& jBr : Nodes[iNd].NbBr) {
+				for (const size_t& jBr : NodeBranches.of(iNd)) {
 					_branch* jBranch = &Branches[jBr];
 					if (Base.showMeshDetail) {
 						printBranch(Branches[jBr], iNd);
@@ -1091,6 +1143,7 @@ void initFlow() {
 	}
 	//4)here re-numbering of nodes
 	renumberNodes(NodesHeatedIn, NodesHeatedOut, NodesDowncomerIn2, NodesDowncomerOut, isNdDownIn, isNdDownOut, isBrDirectionSet);
+	NodeBranches.build(); // node numbers have changed
 
 	//prot << "\n\n after back nodeHeatedIn ";
 	//for (auto &iNodeHeatedIn : NodesHeatedIn)
@@ -1128,16 +1181,15 @@ void initFlow() {
 		}
 		else {
 			// have to look for a path from iNodeHeatedIn to one iNodeDowncomerOut
-			tempVx.push_back(iNodeHeatedIn);
+			tempVx.put(iNodeHeatedIn, 0.);
 			Vertices[iNodeHeatedIn].weight = 0.;
 			while (!tempVx.empty()) {
-				iNd = tempVx.front();
-				tempVx.pop_front();
+				iNd = tempVx.pop();
 				if (Base.showMeshDetail) {
 					prot << "\n---------------------------------------------------------------------------------------\n";
 				}
 				if (isNdDownOut[iNd]) continue;  //NdDownOut is already a target, don't try to search for other connections from here
-				for (size_t& jBr : Nodes[iNd].NbBr) {
+				for (const size_t& jBr : NodeBranches.of(iNd)) {
 					_branch* jBranch = &Branches[jBr];
 					if (Base.showMeshDetail) {
 						printBranch(Branches[jBr], iNd);
@@ -1186,6 +1238,7 @@ void initFlow() {
 			while (iNd != iNodeHeatedIn) {
 				otherNode = Vertices[iNd].NbNdPrev;
 				std::reverse(Nodes[otherNode].NbBr.begin(), Nodes[otherNode].NbBr.end());
+				NodeBranches.reverse(otherNode);
 				// if there are 2 parallel branches between downcomer and last node before, 
 				// the branch that comes in the vector NbBr first will be preferred
 				// therefore after being in final path the vector will be reversed  
@@ -1292,17 +1345,16 @@ void initFlow() {
 		Flow = Nodes[iNodeHeatedOut].gSumArrive;
 		initialize_Vertices(Vertices);
 		// have to look for a path or paths from iNodeHeatedOut to drum
-		tempVx.push_back(iNodeHeatedOut);
+		tempVx.put(iNodeHeatedOut, 0.);
 		Vertices[iNodeHeatedOut].weight = 0.;
 		minWeightTarget = 1e30;
 		while (!tempVx.empty()) {
-			iNd = tempVx.front();
-			tempVx.pop_front();
+			iNd = tempVx.pop();
 			if (iNd == DRUM) continue;   // don't go further from drum 
 			if (Base.showMeshDetail) {
 				prot << "\n---------------------------------------------------------------------------------------\n";
 			}
-			for (size_t& jBr : Nodes[iNd].NbBr) {
+			for (const size_t& jBr : NodeBranches.of(iNd)) {
 				_branch* jBranch = &Branches[jBr];
 				if (Base.showMeshDetail) {
 					printBranch(Branches[jBr], iNd);
@@ -12,126 +12,25 @@ using namespace std;
 extern int findMaxNodesConnected();
 
 /*!
- * \brief calculates the water/steam flow in a closed network of tubes in natural circulation
- *
- * \param argc number of arguments
- * \param argv program arguments, the name of the data project
- * \return int
-* \author Rainer_Jordan@<very, very warm>mail.com
-* #### Licence
-* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
-* \date   September 2021
- *********************************************************************/
- /*!
- * ---------
- *
- *    Copyright 2021 Rainer Jordan
- *
- *    Licensed under the European Union Public Licence (EUPL), Version 1.2 or - as soon they
- *    will be approved by the European Commission - subsequent
- *    versions of the EUPL (the "Licence");\n
- *    You may not use this work except in compliance with the Licence.
+ * \brief iteration of the flow in branches of the active model, starting from the flow and node pressures set
  *
- *    You may obtain a copy of the Licence at:
- *
- *    https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12 (and chose your language)
- *
- *    Unless required by applicable law or agreed to in
- *    writing, software distributed under the Licence is
- *    distributed on an "AS IS" basis,
- *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
- *    express or implied.
- *    See the Licence for the specific language governing
- *    permissions and limitations under the Licence.
- *
- * -----------------
+ * \param isInteractive true: each iteration step is shown on console and if the maximum number of iterations is reached the user is asked if the result is close enough,
+ * false: no output on console, the result is not converged then
+ * \return true if the iteration converged
  */
-
-int main(int argc, char** argv) {
+bool FlowIteration(bool isInteractive) {
 	/* Local variables */
-	string protname, Project, readG, iname, rname, cname, line, TubeName;
 	double diff, dissipation;
 	bool maxg = false;
 	double diffsum;
 	char answer;
-
-	ifstream gReadData;
-	ofstream dchange;
-	//      istringstream iss;
-	/* ---------- */
-	/* data input */
-	/* ---------- */
-	if (argc > 1) {
-		Project = argv[1];
-	}
-	else {
-		cout << "\nProject name : ";
-		cin >> Project;
-	}
-//	PathFile = "..\\..\\WSCDATA\\" + Project + "\\" + Project;
-	PathFile = "WSCDATA\\" + Project + "\\" + Project;
-	protname = PathFile + ".pro";
-//	cout << protname;
-	// Set exceptions to be thrown on failure
-	prot.exceptions(ofstream::failbit | ofstream::badbit);
-
-	try {
-		prot.open(protname.c_str());
-	}
-	catch (system_error& e) {
-		cerr << protname << " : " << e.code().message() << endl;
-		exit(1);
-	}
-	FileNames.push_back(protname);
-
-	/**
-	 * This is the main program to call the different functions.
-	 *
-	 * 1) input data is read from file\n
-	* function: readData() */
-	/* ------------------- */
-	readData();
-
-	/**
-	* 2) Setting up Mesh (network) and the initial flow in Branches\n
-	* function: Mesh()   */
-	/* ------------------------------------------------- */
-	Mesh();
 	//size the matrix and vectors for equation system, mNd is known now
-	//allocated here once,
+	//allocated here once for all iteration steps
 	SparseMatrix <double> S(mNd, mNd); /* System sparse matrix */
 	S.reserve(VectorXi::Constant(mNd, findMaxNodesConnected() + 2));
 	VectorXd B(mNd); /* right hand side vector............*/
 	VectorXd X(mNd); /* solution vector ...................*/
 
-  /* --------------------------------- */
-  /** 3) although the initial flow in the branches is set, it can be overwritten by data from file "*projectname*StartFlow.dat" */
-  /* --------------------------------- */
-	readG = PathFile + "startFlow.dat";
-
-	gReadData.open(readG.c_str());
-	if (!gReadData.good()) {
-		cout << "\n no start values for flow available, using build-in values" << endl;
-	}
-	else {
-		size_t BranchNumber;
-		for (size_t
-			i = 0; i <= mBr; ++i) {
-			gReadData >> BranchNumber;
-			gReadData >> Branches[BranchNumber].g;
-			if (Branches[BranchNumber].g < 0.) {
-				Branches[BranchNumber].reverseDirection();
-				Branches[BranchNumber].g = -Branches[BranchNumber].g;
-			}
-		}
-		gReadData.close();
-	}//file opened correctly
-	 /*     --------------------------------- */
-	/** 4) Initial guess for Node Pressure   */
-	/*     --------------------------------- */
-	for (auto& iNode : Nodes) {
-		iNode.pNode = 0.9 * Drum.rhoW * 9.80665 * (100. - iNode.Elev); //drum elevation is 100m
-	}
 	/* -------------------------------- */
 	 /** 5) start of main loop to calculate the flow in branches  */
 	 /* -------------------------------- */
@@ -152,6 +51,9 @@ int main(int argc, char** argv) {
 		 * function: saveFlow() */
 		 /* ----------------- */
 		saveFlow();
+		if (Base.CheckpointEvery > 0 && Base.iterg % Base.CheckpointEvery == 0) {
+			saveCheckpoint(PathFile + ".wcp");
+		}
 		if (Base.showFlow) {
 			Print2dxf(ShowMode::Flow);
 			Print2dxf(ShowMode::Arrows);
@@ -164,7 +66,7 @@ int main(int argc, char** argv) {
 		/*     ------------------------------------------------ */
 		/**8) Calculation of pressure difference in branches and factors for characteristic curves\n
 		*      Model: dp = dPLinear*g + dPConstant\n
-		* function: _branch.dpBranch() */
+		* function: dpAllBranches() calling _branch.dpBranch() for all branches in parallel */
 		/*     ------------------------------------------------ */
 		maxg = false;
 		if (Base.showDPBranch) {
@@ -173,22 +75,13 @@ int main(int argc, char** argv) {
 			prot << "\n   *************" << endl;
 		}
 
-		for (auto& iBranch : Branches) {
+		for (const auto& iBranch : Branches) {
 			if (Tubes[iBranch.NbTbInBr[0]].xIn > 1.) {
 				cout << " XIn in branch " << iBranch.Number << "  > 1." << endl;
 			}
-			if (Base.showDPBranch) {
-				prot << "\n\n   *************";
-				prot << "\n   * Branch # " << iBranch.Number << endl;
-			}
-			if (iBranch.isFlowSet2zero) {
-				if (Base.showDPBranch) {
-					prot << "\n Flow is set to 0 " << endl;
-				}
-			}
-			else {
-				iBranch.dpBranch();
-			}
+		}
+		dpAllBranches(true, true);
+		for (const auto& iBranch : Branches) {
 			//         prot << "\n no " << iBranch.Number << " g " << iBranch.g << " dPlin " << iBranch.dPLinear << " dPconst " << iBranch.dPConstant;
 			if (Tubes[iBranch.NbTbInBr[0]].xIn > 1.) {
 				cout << " XIn in branch " << iBranch.Number << "  > 1." << endl;
@@ -242,7 +135,9 @@ int main(int argc, char** argv) {
 			prot << "\n Iteration " << Base.iterg << " Flow in branches: sum of differences " << diffsum << " flow in drum " << Nodes[0].gSum;
 			prot << "\n" << Branches[Branchmax].Number << "\t" << Branches[Branchmax].g << "\t" << Branches[Branchmax].gNew << "\t" << fabs(Branches[Branchmax].g - Branches[Branchmax].gNew) << "\t" << diffmax << endl;
 		}
-		cout << "\n Iteration " << Base.iterg << " Flow in branches: sum of differences " << diffsum << " max diff " << diffmax << "% in Branch " << Branchmax << endl;
+		if (isInteractive) {
+			cout << "\n Iteration " << Base.iterg << " Flow in branches: sum of differences " << diffsum << " max diff " << diffmax << "% in Branch " << Branchmax << endl;
+		}
 		//      cout << "\n pnode1 " << Nodes[1].pNode << " full static " << Drum.rhoW * 9.80665 * (100. - Nodes[1].Elev);
 		if ((maxg && (fabs(Nodes[0].gSum) < Base.tol)) || diffsum < Base.tol) {
 			maxg = true;
@@ -251,10 +146,17 @@ int main(int argc, char** argv) {
 		if (Base.iterg >= Base.maxit) {
 			//        Base.showNodePressure = true;
 			if (Base.iterg == Base.maxit + 2) {
-				cout << "\n\nMaximum number of iterations reached. Is result close enough (y/n)? ";
-				cin >> answer;
-				if (answer != 'n') {
-					maxg = true;
+				if (isInteractive) {
+					if (Base.isAcceptMaxit) {
+						maxg = true;
+					}
+					else if (!Base.isBatch) {
+						cout << "\n\nMaximum number of iterations reached. Is result close enough (y/n)? ";
+						cin >> answer;
+						if (answer != 'n') {
+							maxg = true;
+						}
+					}
 				}
 				break;
 			}
@@ -270,12 +172,301 @@ int main(int argc, char** argv) {
 	/** 13) end of iteration loop                  */
 	/** 14) once more updating tube data with final flow */
 	/* -------------------------------------------- */
-	for (auto& iBranch : Branches) {
-		if (Base.showDPBranch) {
-			prot << "\n\n   *************";
-			prot << "\n   * Branch # " << iBranch.Number << endl;
+	dpAllBranches(false, false);
+	return maxg;
+}
+
+/*!
+ * \brief reads the options of a configuration file (option --config=file)
+ *
+ * each line is an option without the leading "--" (f.i. solver=newton or batch), the project name is given by project=name,
+ * empty lines and lines starting with # are ignored
+ * \param FileName name of the configuration file
+ * \param [out] Args the options as on the command line, appended
+ * \return false if the file cannot be opened
+ */
+static bool readConfig(const string& FileName, vector<string>& Args) {
+	ifstream Config(FileName);
+	if (!Config) {
+		return false;
+	}
+	string Line;
+	while (getline(Config, Line)) {
+		Line.erase(0, Line.find_first_not_of(" \t"));
+		Line.erase(Line.find_last_not_of(" \t\r") + 1);
+		if (Line.empty() || Line[0] == '#') {
+			continue;
+		}
+		if (Line.rfind("project=", 0) == 0) {
+			Args.push_back(Line.substr(8));
+		}
+		else {
+			Args.push_back("--" + Line);
 		}
-		iBranch.dpBranch();
+	}
+	return true;
+}
+
+/*!
+ * \brief calculates the water/steam flow in a closed network of tubes in natural circulation
+ *
+ * \param argc number of arguments
+ * works on the model activated for the calling thread
+ * \param argv program arguments, the name of the data project, option --solver=newton for Newton iteration of the flow,
+ * --config=file for options from a configuration file (the command line overrides them), --batch for calculation without console input
+ * \return int exit code: 0 converged, 1 input or calculation error, 2 iteration not converged, 3 wrong options or missing project name
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+* \date   September 2021
+ *********************************************************************/
+ /*!
+ * ---------
+ *
+ *    Copyright 2021 Rainer Jordan
+ *
+ *    Licensed under the European Union Public Licence (EUPL), Version 1.2 or - as soon they
+ *    will be approved by the European Commission - subsequent
+ *    versions of the EUPL (the "Licence");\n
+ *    You may not use this work except in compliance with the Licence.
+ *
+ *    You may obtain a copy of the Licence at:
+ *
+ *    https://joinup.ec.europa.eu/collection/eupl/eupl-text-eupl-12 (and chose your language)
+ *
+ *    Unless required by applicable law or agreed to in
+ *    writing, software distributed under the Licence is
+ *    distributed on an "AS IS" basis,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *    express or implied.
+ *    See the Licence for the specific language governing
+ *    permissions and limitations under the Licence.
+ *
+ * -----------------
+ */
+
+static int calculate(int argc, char** argv) {
+	/* Local variables */
+	string protname, Project, readG, iname, rname, cname, line, TubeName;
+	bool maxg = false;
+	char answer;
+
+	ifstream gReadData;
+	ofstream dchange;
+	//      istringstream iss;
+	/* ---------- */
+	/* data input */
+	/* ---------- */
+	Base.Solver = SolverKind::FixedPoint;
+	Base.AndersonWindow = 5;
+	Base.SkipTol = 0.;
+	Base.DpTol = 0.;
+	Base.WaterFastTol = 0.;
+	Base.CheckpointEvery = 0;
+	Base.isRestart = false;
+	Base.SweepThreads = 0;
+	Base.isBatch = false;
+	Base.isAcceptMaxit = false;
+	Base.isKeepFiles = false;
+	// options of configuration files first, so that the command line overrides them
+	vector<string> Args;
+	for (int iArg = 1; iArg < argc; ++iArg) {
+		string Arg = argv[iArg];
+		if (Arg.rfind("--config=", 0) == 0 && !readConfig(Arg.substr(9), Args)) {
+			cout << "\n configuration file " << Arg.substr(9) << " cannot be opened" << endl;
+			return 3;
+		}
+	}
+	for (int iArg = 1; iArg < argc; ++iArg) {
+		Args.push_back(argv[iArg]);
+	}
+	for (const auto& Arg : Args) {
+		if (Arg.rfind("--config=", 0) == 0) {
+			continue;
+		}
+		else if (Arg == "--batch") {
+			Base.isBatch = true;
+		}
+		else if (Arg == "--accept-maxit") {
+			Base.isAcceptMaxit = true;
+		}
+		else if (Arg == "--keep-files") {
+			Base.isKeepFiles = true;
+		}
+		else if (Arg == "--solver=newton") {
+			Base.Solver = SolverKind::Newton;
+		}
+		else if (Arg == "--solver=fixedpoint") {
+			Base.Solver = SolverKind::FixedPoint;
+		}
+		else if (Arg == "--solver=anderson") {
+			Base.Solver = SolverKind::Anderson;
+		}
+		else if (Arg.rfind("--anderson-window=", 0) == 0 && atoi(Arg.c_str() + 18) > 0) {
+			Base.AndersonWindow = static_cast<size_t> (atoi(Arg.c_str() + 18));
+		}
+		else if (Arg.rfind("--skip-tol=", 0) == 0 && atof(Arg.c_str() + 11) >= 0.) {
+			Base.SkipTol = atof(Arg.c_str() + 11);
+		}
+		else if (Arg.rfind("--dp-tol=", 0) == 0 && atof(Arg.c_str() + 9) >= 0.) {
+			Base.DpTol = atof(Arg.c_str() + 9);
+		}
+		else if (Arg.rfind("--water-fast=", 0) == 0 && atof(Arg.c_str() + 13) >= 0.) {
+			Base.WaterFastTol = atof(Arg.c_str() + 13);
+		}
+		else if (Arg.rfind("--checkpoint-every=", 0) == 0 && atoi(Arg.c_str() + 19) >= 0) {
+			Base.CheckpointEvery = atoi(Arg.c_str() + 19);
+		}
+		else if (Arg == "--restart") {
+			Base.isRestart = true;
+		}
+		else if (Arg.rfind("--restart=", 0) == 0) {
+			Base.isRestart = true;
+			Base.RestartFile = Arg.substr(10);
+		}
+		else if (Arg.rfind("--sweep=", 0) == 0) {
+			Base.SweepFile = Arg.substr(8);
+		}
+		else if (Arg.rfind("--sweep-threads=", 0) == 0 && atoi(Arg.c_str() + 16) > 0) {
+			Base.SweepThreads = atoi(Arg.c_str() + 16);
+		}
+		else if (Arg.rfind("--", 0) == 0) {
+			cout << "\n unknown option " << Arg << " (--solver=fixedpoint, --solver=newton, --solver=anderson, --anderson-window=n, --skip-tol=x, --dp-tol=x, --water-fast=x, --checkpoint-every=n, --restart[=file], --sweep=file, --sweep-threads=n, --config=file, --batch, --accept-maxit, --keep-files)" << endl;
+			return 3;
+		}
+		else {
+			Project = Arg;
+		}
+	}
+	if (Project.empty()) {
+		if (Base.isBatch) {
+			cout << "\n project name missing" << endl;
+			return 3;
+		}
+		cout << "\nProject name : ";
+		cin >> Project;
+	}
+//	PathFile = "..\\..\\WSCDATA\\" + Project + "\\" + Project;
+	PathFile = "WSCDATA\\" + Project + "\\" + Project;
+	protname = PathFile + ".pro";
+//	cout << protname;
+	// Set exceptions to be thrown on failure
+	prot.exceptions(ofstream::failbit | ofstream::badbit);
+
+	try {
+		prot.open(protname.c_str());
+	}
+	catch (system_error& e) {
+		cerr << protname << " : " << e.code().message() << endl;
+		return 1;
+	}
+	FileNames.push_back(protname);
+	if (Base.Solver == SolverKind::Newton) {
+		prot << "\n Newton solver for flow in branches" << endl;
+	}
+	else if (Base.Solver == SolverKind::Anderson) {
+		prot << "\n Anderson acceleration for flow in branches, window " << Base.AndersonWindow << endl;
+	}
+	if (Base.SkipTol > 0.) {
+		prot << "\n branches with inputs changed less than " << Base.SkipTol << " (relative) are not calculated again" << endl;
+	}
+	if (Base.DpTol > 0.) {
+		prot << "\n section length of tubes adaptive, tolerance of pressure difference " << Base.DpTol << " Pa" << endl;
+	}
+	if (Base.WaterFastTol > 0.) {
+		prot << "\n unheated tubes with subcooled water in closed form, if pressure changes less than " << Base.WaterFastTol << " of inlet pressure" << endl;
+	}
+
+	/**
+	 * This is the main program to call the different functions.
+	 *
+	 * 1) input data is read from file\n
+	 * from the binary model file "*projectname*.wscb" if it is not older than the .dat file, otherwise from the .dat file\n
+	* function: readModel(), readData() */
+	/* ------------------- */
+	_meshTopology Topology;
+	string ModelInput;
+	if (isModelFileCurrent()) {
+		readModel(Topology);
+	}
+	else {
+		readData();
+	}
+	if (!Topology.isValid) {
+		ModelInput = modelInput();
+	}
+	// calculation method for 2-phase flow is chosen once here, not per tube section
+	SelectTwoPhaseMethod();
+
+	/**
+	* 2) Setting up Mesh (network) and the initial flow in Branches\n
+	* the mesh is taken from the binary model file if it has one, otherwise it is determined and saved with the input to the binary model file\n
+	* function: Mesh(), saveModel()   */
+	/* ------------------------------------------------- */
+	Mesh(Topology);
+	if (!ModelInput.empty()) {
+		saveModel(ModelInput, Topology);
+	}
+	/** with option --sweep all load cases of the case table are calculated from this model\n
+	* function: Sweep() */
+	if (!Base.SweepFile.empty()) {
+		return Sweep();
+	}
+
+  /* --------------------------------- */
+  /** 3) although the initial flow in the branches is set, it can be overwritten by data from file "*projectname*StartFlow.dat" */
+  /* --------------------------------- */
+	readG = PathFile + "startFlow.dat";
+
+	gReadData.open(readG.c_str());
+	if (!gReadData.good()) {
+		cout << "\n no start values for flow available, using build-in values" << endl;
+	}
+	else {
+		size_t BranchNumber;
+		for (size_t
+			i = 0; i <= mBr; ++i) {
+			gReadData >> BranchNumber;
+			gReadData >> Branches[BranchNumber].g;
+			if (Branches[BranchNumber].g < 0.) {
+				Branches[BranchNumber].reverseDirection();
+				Branches[BranchNumber].g = -Branches[BranchNumber].g;
+			}
+		}
+		gReadData.close();
+	}//file opened correctly
+	 /*     --------------------------------- */
+	/** 4) Initial guess for Node Pressure   */
+	/*     --------------------------------- */
+	for (auto& iNode : Nodes) {
+		iNode.pNode = 0.9 * Drum.rhoW * 9.80665 * (100. - iNode.Elev); //drum elevation is 100m
+	}
+	/** with option --restart the start values of nodes, branches and tubes are read from checkpoint file (*projectname*.wcp or given file)\n
+	* function: readCheckpoint() */
+	if (Base.isRestart) {
+		if (Base.RestartFile.empty()) {
+			Base.RestartFile = PathFile + ".wcp";
+		}
+		readCheckpoint(Base.RestartFile);
+	}
+	/* -------------------------------- */
+	 /** 5) - 14) iteration of the flow in branches\n
+	 * function: FlowIteration() */
+	 /* -------------------------------- */
+	maxg = FlowIteration(true);
+	if (Base.DpTol > 0.) {
+		/** 15) with adaptive section length the number of sections of each tube is written to protocol */
+		int SumFixed = 0;
+		int SumAdaptive = 0;
+		prot << "\n\n tube\tsections fixed\tsections adaptive";
+		for (const auto& iTube : Tubes) {
+			if (iTube.isSectioned()) {
+				prot << "\n" << setw(5) << iTube.Number << "\t" << setw(8) << iTube.NoSections << "\t" << setw(8) << iTube.NoStepsAdaptive;
+				SumFixed += iTube.NoSections;
+				SumAdaptive += iTube.NoStepsAdaptive;
+			}
+		}
+		prot << "\n total\t" << setw(8) << SumFixed << "\t" << setw(8) << SumAdaptive << endl;
 	}
 	if (maxg) {
 		/* -------------- */
@@ -283,6 +474,9 @@ int main(int argc, char** argv) {
 		* function : SaveResults() */
 		/* -------------- */
 		SaveResults();
+		/** 17) save state of converged iteration as checkpoint (*projectname*.wcp), start values for a following calculation with option --restart\n
+		* function : saveCheckpoint() */
+		saveCheckpoint(PathFile + ".wcp");
 	}
 
 	cname = PathFile + ".bcd";
@@ -294,7 +488,7 @@ int main(int argc, char** argv) {
 	}
 	catch (std::system_error& e) {
 		std::cerr << e.code().message() << std::endl;
-		exit(1);
+		return 1;
 	}
 	dchange << "\n branch\tdirection changes" << endl;
 	for (const auto& iBranch : Branches) {
@@ -309,8 +503,16 @@ int main(int argc, char** argv) {
 		cout << "\n successful iteration" << endl;
 		prot << "\n successful iteration" << endl;
 		prot.close();
-		cout << "Delete the intermediate/temporary files (y/n)? ";
-		cin >> answer;
+		if (Base.isKeepFiles) {
+			answer = 'n';
+		}
+		else if (Base.isBatch) {
+			answer = 'y';
+		}
+		else {
+			cout << "Delete the intermediate/temporary files (y/n)? ";
+			cin >> answer;
+		}
 		if (answer != 'n') {
 			for (const auto& iFileName : FileNames) {
 //				cout << iFileName<<"\n";
@@ -322,9 +524,33 @@ int main(int argc, char** argv) {
 		cout << "\n iteration not converging" << endl;
 		prot << "\n iteration not converging max. iterations: " << Base.maxit << " iterations:  " << Base.iterg << endl;
 		prot.close();
+		return 2;
 	}
 
 	return 0;
+}
+
+/*!
+ * \brief creates the model and activates it for the main thread, then calculate()
+ *
+ * an error during the calculation (_wscError) stops the calculation of the model, its code is the exit code
+ * \param argc number of arguments
+ * \param argv program arguments, see calculate()
+ * \return int exit code
+ */
+int main(int argc, char** argv) {
+	_circulationModel Model;
+	_activeModel Active(Model);
+	try {
+		return calculate(argc, argv);
+	}
+	catch (const _wscError& Error) {
+		if (prot.File.is_open()) {
+			prot.setBuffer(nullptr);
+			prot << "\n calculation stopped: " << Error.what() << endl;
+		}
+		return Error.Code;
+	}
 } /* MAIN__ */
 
 
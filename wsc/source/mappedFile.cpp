@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * \file   mappedFile.cpp
+ * \brief read-only mapping of a whole file into memory
+ *
+ * POSIX mmap, on Windows a file mapping object
+ *
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#undef MAINFUNCTION
+#include "CommonHeader.h"
+
+using namespace std;
+
+_mappedFile::_mappedFile(const string& FileName) {
+#ifdef _WIN32
+	HANDLE File = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (File == INVALID_HANDLE_VALUE) {
+		throw _wscError(FileName + " : cannot open file");
+	}
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(File, &FileSize)) {
+		CloseHandle(File);
+		throw _wscError(FileName + " : cannot get file size");
+	}
+	Size = static_cast<size_t>(FileSize.QuadPart);
+	if (Size > 0) {
+		Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (Mapping != nullptr) {
+			Data = static_cast<const char*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+	}
+	CloseHandle(File);
+	if (Size > 0 && Data == nullptr) {
+		if (Mapping != nullptr) CloseHandle(Mapping);
+		throw _wscError(FileName + " : cannot map file");
+	}
+#else
+	int File = open(FileName.c_str(), O_RDONLY);
+	if (File < 0) {
+		throw _wscError(FileName + " : " + generic_category().message(errno));
+	}
+	struct stat FileStat;
+	if (fstat(File, &FileStat) != 0) {
+		int Error = errno;
+		close(File);
+		throw _wscError(FileName + " : " + generic_category().message(Error));
+	}
+	Size = static_cast<size_t>(FileStat.st_size);
+	if (Size > 0) {
+		void* View = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, File, 0);
+		if (View == MAP_FAILED) {
+			int Error = errno;
+			close(File);
+			throw _wscError(FileName + " : " + generic_category().message(Error));
+		}
+		// read once from start to end
+		madvise(View, Size, MADV_SEQUENTIAL);
+		Data = static_cast<const char*>(View);
+	}
+	close(File); // the mapping stays valid
+#endif
+}
+
+_mappedFile::~_mappedFile() {
+	if (Data == nullptr) return;
+#ifdef _WIN32
+	UnmapViewOfFile(Data);
+	CloseHandle(Mapping);
+#else
+	munmap(const_cast<char*>(Data), Size);
+#endif
+}
@@ -0,0 +1,517 @@
+/*****************************************************************//**
+ * \file   modelFile.cpp
+ * \brief reading and saving the binary model file (*projectname*.wscb), layout see modelFile.h
+ *
+ * the input is read from the file mapped into memory without parsing any text,
+ * the mesh determined by Mesh() is saved with it and taken from it in the next calculation
+ *
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#undef MAINFUNCTION
+#include "CommonHeader.h"
+#include "modelFile.h"
+
+using namespace std;
+
+/// appends the bytes of a record
+template <class T> static void append(string& Data, const T& Record) {
+	Data.append(reinterpret_cast<const char*>(&Record), sizeof(T));
+}
+
+/// copies a record from the mapped file and advances Position
+template <class T> static void take(const char*& Position, T& Record) {
+	memcpy(&Record, Position, sizeof(T));
+	Position += sizeof(T);
+}
+
+static void ErrorModel(const string& FileName, const string& text) {
+	cout << "\n " << FileName << " : " << text;
+	prot << "\n " << FileName << " : " << text;
+	throw _wscError(FileName + " : " + text);
+}
+
+static void ErrorModelTube(const string& FileName, size_t iTb, const string& text) {
+	ErrorModel(FileName, "tube # " + to_string(iTb) + text);
+}
+
+bool isModelFileCurrent() {
+	error_code ec;
+	filesystem::path ModelName(PathFile + ".wscb");
+	filesystem::path DataName(PathFile + ".dat");
+	if (!filesystem::exists(ModelName, ec)) return false;
+	if (!filesystem::exists(DataName, ec)) return true;
+	auto DataTime = filesystem::last_write_time(DataName, ec);
+	if (ec) return false;
+	auto ModelTime = filesystem::last_write_time(ModelName, ec);
+	if (ec) return false;
+	return DataTime <= ModelTime;
+}
+
+/**
+ * \brief the mesh block of the file
+ *
+ * all numbers are checked, the mesh is only used if it fits to the input
+ * \return false if the mesh cannot be used, Topology is not valid then
+ */
+static bool readMesh(const char* Begin, uint64_t SizeMesh, const _wscbHeader& Header, _meshTopology& Topology) {
+	_wscbMesh Head;
+	const char* Position = Begin;
+
+	if (SizeMesh < sizeof(_wscbMesh)) return false;
+	take(Position, Head);
+	if (Head.MeshVersion != WscbMeshVersion || Head.InputHash != Header.InputHash) return false;
+	uint64_t SizeRest = SizeMesh - sizeof(_wscbMesh);
+	if (Head.NoNodes == 0 || Head.NoNodes > SizeRest / sizeof(_wscbNode) ||
+		Head.NoBranches > SizeRest / sizeof(_wscbBranch) || Head.NoLinks > SizeRest / sizeof(uint64_t) ||
+		Header.NoTubes * sizeof(_wscbMeshTube) + Head.NoNodes * sizeof(_wscbNode) +
+		Head.NoBranches * sizeof(_wscbBranch) + Head.NoLinks * sizeof(uint64_t) != SizeRest) return false;
+	if (wscbHash(Position, SizeRest) != Head.MeshHash) return false;
+
+	size_t NoTubes = Header.NoTubes;
+	size_t NoPoints = Header.NoPoints;
+	size_t NoNodes = Head.NoNodes;
+	size_t NoBranches = Head.NoBranches;
+	Topology.isReversed.resize(NoTubes);
+	Topology.beta.resize(NoTubes);
+	Topology.UorS.resize(NoTubes);
+	for (size_t iTb = 0; iTb < NoTubes; ++iTb) {
+		_wscbMeshTube MeshTube;
+		take(Position, MeshTube);
+		if (MeshTube.isReversed > 1 || MeshTube.UorS > static_cast<uint64_t>(USArrangement::U)) return false;
+		Topology.isReversed[iTb] = static_cast<uint8_t>(MeshTube.isReversed);
+		Topology.beta[iTb] = MeshTube.beta;
+		Topology.UorS[iTb] = static_cast<USArrangement>(MeshTube.UorS);
+	}
+	vector<_wscbNode> NodeRecords(NoNodes);
+	for (auto& iRecord : NodeRecords) {
+		take(Position, iRecord);
+	}
+	vector<_wscbBranch> BranchRecords(NoBranches);
+	for (auto& iRecord : BranchRecords) {
+		take(Position, iRecord);
+	}
+	const char* ListEnd = Position + Head.NoLinks * sizeof(uint64_t);
+	// next list of Number entries, all below Limit
+	auto takeList = [&Position, ListEnd](uint64_t Number, size_t Limit, stVector& List) -> bool {
+		if (Number > static_cast<uint64_t>(ListEnd - Position) / sizeof(uint64_t)) return false;
+		List.resize(Number);
+		for (auto& iEntry : List) {
+			uint64_t Entry;
+			take(Position, Entry);
+			if (Entry >= Limit) return false;
+			iEntry = Entry;
+		}
+		return true;
+	};
+
+	// the tubes of the points: the same tubes as in the input, only the order may differ
+	Topology.PointTubes.resize(NoPoints);
+	for (size_t iPt = 0; iPt < NoPoints; ++iPt) {
+		stVector& List = Topology.PointTubes[iPt];
+		if (!takeList(Points[iPt].NoTb, NoTubes, List)) return false;
+		stVector Sorted(List);
+		sort(Sorted.begin(), Sorted.end());
+		if (Sorted != Points[iPt].NbTb) return false;
+	}
+	Topology.NodesMeshed.assign(NoNodes, _node());
+	for (size_t iNd = 0; iNd < NoNodes; ++iNd) {
+		const _wscbNode& Record = NodeRecords[iNd];
+		_node& iNode = Topology.NodesMeshed[iNd];
+		if (Record.NbPt >= NoPoints || Record.NoBr != Record.NoBrArrive + Record.NoBrLeave ||
+			Record.IsT > 1 || Record.TOrientation > static_cast<uint64_t>(TeeOrientation::OffVerDown)) return false;
+		iNode.Number = iNd;
+		iNode.NbPt = Record.NbPt;
+		iNode.Elev = Record.Elev;
+		if (!takeList(Record.NoBr, NoBranches, iNode.NbBr) ||
+			!takeList(Record.NoBrArrive, NoBranches, iNode.NbBrArrive) ||
+			!takeList(Record.NoBrLeave, NoBranches, iNode.NbBrLeave)) return false;
+		iNode.mBrInNd = iNode.NbBr.size() - 1;
+		iNode.mBrArrive = iNode.NbBrArrive.size() - 1;
+		iNode.mBrLeave = iNode.NbBrLeave.size() - 1;
+		iNode.IsT = Record.IsT != 0;
+		iNode.NbTbTStraight[0] = Record.NbTbTStraight[0];
+		iNode.NbTbTStraight[1] = Record.NbTbTStraight[1];
+		iNode.NbTbTOff = Record.NbTbTOff;
+		iNode.NbBrTStraight[0] = Record.NbBrTStraight[0];
+		iNode.NbBrTStraight[1] = Record.NbBrTStraight[1];
+		iNode.NbBrTOff = Record.NbBrTOff;
+		iNode.TOrientation = static_cast<TeeOrientation>(Record.TOrientation);
+		memcpy(iNode.AngleT, Record.AngleT, sizeof(iNode.AngleT));
+	}
+	if (Topology.NodesMeshed[DRUM].NbPt != DRUM) return false;
+	// each tube belongs to exactly one branch
+	vector<uint8_t> isInBranch(NoTubes, 0);
+	Topology.BranchesMeshed.assign(NoBranches, _branch());
+	for (size_t iBr = 0; iBr < NoBranches; ++iBr) {
+		const _wscbBranch& Record = BranchRecords[iBr];
+		_branch& iBranch = Topology.BranchesMeshed[iBr];
+		if (Record.NbPtIn >= NoPoints || Record.NbPtOut >= NoPoints ||
+			Record.NbNdIn >= NoNodes || Record.NbNdOut >= NoNodes || Record.NoTubes == 0) return false;
+		iBranch.Number = iBr;
+		iBranch.NbPtIn = Record.NbPtIn;
+		iBranch.NbPtOut = Record.NbPtOut;
+		iBranch.NbNdIn = Record.NbNdIn;
+		iBranch.NbNdOut = Record.NbNdOut;
+		if (!takeList(Record.NoTubes, NoTubes, iBranch.NbTbInBr)) return false;
+		iBranch.mTbInBr = iBranch.NbTbInBr.size() - 1;
+		for (auto iTb : iBranch.NbTbInBr) {
+			if (isInBranch[iTb] || Tubes[iTb].Number == MINUS1) return false;
+			isInBranch[iTb] = 1;
+			iBranch.qSum += Tubes[iTb].q;
+		}
+	}
+	for (size_t iTb = 0; iTb < NoTubes; ++iTb) {
+		if (!isInBranch[iTb] && Tubes[iTb].Number != MINUS1) return false;
+	}
+	return Position == ListEnd;
+}
+
+void readModel(_meshTopology& Topology) {
+	string FileName = PathFile + ".wscb";
+	_wscbHeader Header;
+	_wscbBase BaseData;
+	double LevelHighestPoint = 0.;
+	double LevelLowestPoint = 100.;
+
+	/**
+	 * 1.) checking the header: identifier, version, byte order, sizes and hash of the input
+	 */
+	if (!wscbIsLittleEndian()) {
+		ErrorModel(FileName, "binary model file can only be read on little-endian computers");
+	}
+	_mappedFile inModel(FileName);
+	const char* Begin = inModel.data();
+	const uint64_t Size = inModel.size();
+	if (Size < sizeof(_wscbHeader) + sizeof(_wscbBase)) {
+		ErrorModel(FileName, "no binary model file (too short)");
+	}
+	memcpy(&Header, Begin, sizeof(_wscbHeader));
+	if (memcmp(Header.Id, WscbId, sizeof(WscbId)) != 0 || Header.ByteOrder != WscbByteOrder) {
+		ErrorModel(FileName, "no binary model file");
+	}
+	if (Header.Version != WscbVersion) {
+		ErrorModel(FileName, "version " + to_string(Header.Version) + " of binary model file not supported");
+	}
+	uint64_t SizeData = Size - sizeof(_wscbHeader) - sizeof(_wscbBase);
+	if (Header.NoPoints == 0 || Header.NoTubes == 0 ||
+		Header.NoPoints > SizeData / sizeof(_wscbPoint) || Header.NoTubes > SizeData / sizeof(_wscbTube) ||
+		Header.SizeNames > SizeData || Header.SizeMesh > SizeData || Header.SizeNames % 8 != 0 ||
+		Header.NoPoints * sizeof(_wscbPoint) + Header.NoTubes * sizeof(_wscbTube) + Header.SizeNames +
+		Header.SizeMesh != SizeData) {
+		ErrorModel(FileName, "file is damaged (wrong size)");
+	}
+	uint64_t SizeInput = Size - sizeof(_wscbHeader) - Header.SizeMesh;
+	if (wscbHash(Begin + sizeof(_wscbHeader), SizeInput) != Header.InputHash) {
+		ErrorModel(FileName, "file is damaged (wrong hash)");
+	}
+	cout << "\n input read from binary model file " << FileName << endl;
+	prot << "\n input read from binary model file " << FileName << "\n";
+	const char* Position = Begin + sizeof(_wscbHeader);
+
+	/**
+	 * 2.) base data, the same as the first 3 lines of the data file (readData)
+	 */
+	take(Position, BaseData);
+	Base.maxit = static_cast<int>(BaseData.maxit);
+	Base.tol = BaseData.tol;
+	Base.Method = static_cast<char>(BaseData.Method);
+	int control = static_cast<int>(BaseData.Control);
+	prot << " maxit " << Base.maxit << " control " << control;
+	setControl(control);
+	Drum.pMPa = BaseData.pMPa;
+	Base.Rough = BaseData.Rough;
+	Base.LevelFact = BaseData.LevelFact;
+	Drum.LevelW = BaseData.LevelW;
+	Base.CRStart = BaseData.CRStart;
+	setDrumProperties();
+	Drum.dpDyn = BaseData.dpDyn;
+
+	/**
+	 * 3.) points, the index is the point number
+	 */
+	mPt = Header.NoPoints - 1;
+	mTb = Header.NoTubes - 1;
+	Points.assign(Header.NoPoints, _point());
+	Tubes.assign(Header.NoTubes, _tube());
+	TubesOutput.assign(Header.NoTubes, _tubeOutput());
+	for (size_t iPt = 0; iPt <= mPt; ++iPt) {
+		_wscbPoint Record;
+		take(Position, Record);
+		if (Record.Number == MINUS1) continue;
+		if (Record.Number != iPt) {
+			ErrorModel(FileName, "point # " + to_string(iPt) + " has a wrong number");
+		}
+		Points[iPt].Number = iPt;
+		Points[iPt].xCoord = Record.xCoord; // mm
+		Points[iPt].yCoord = Record.yCoord; // mm
+		Points[iPt].zCoord = Record.zCoord; // mm
+		LevelHighestPoint = fmax(LevelHighestPoint, Record.zCoord / 1e3);// ->m
+		LevelLowestPoint = fmin(LevelLowestPoint, Record.zCoord / 1e3);// ->m
+	}
+
+	/**
+	 * 4.) tubes, the index is the tube number, the same checks as in readData\n
+	 * the geometry is already calculated (wscbGeometry)
+	 */
+	for (size_t iTb = 0; iTb <= mTb; ++iTb) {
+		_wscbTube Record;
+		take(Position, Record);
+		if (Record.Number == MINUS1) continue;
+		if (Record.Number != iTb) {
+			ErrorModelTube(FileName, iTb, " has a wrong number");
+		}
+		if (Record.PointIn > mPt || Record.PointOut > mPt) {
+			ErrorModelTube(FileName, iTb, " : tube point number higher than maximum number");
+		}
+		if (Record.Dia * 1e3 < 1.) {
+			ErrorModelTube(FileName, iTb, " inside diameter too small");
+		}
+		if (Record.Length < 1e-3) {
+			ErrorModelTube(FileName, iTb, " length too short");
+		}
+		if (Record.NoParallel < 1.) {
+			ErrorModelTube(FileName, iTb, " too few number of parallel tubes");
+		}
+		if (Record.FactHeat < .001 || Record.FactHeat > 2.) {
+			ErrorModelTube(FileName, iTb, " wrong heating position factor");
+		}
+		if (Record.DiaOrificeIn > Record.Dia || Record.DiaOrificeIn < 0.) {
+			ErrorModelTube(FileName, iTb, " wrong inlet orifice diameter");
+		}
+		if (Record.DiaOrificeOut > Record.Dia || Record.DiaOrificeOut < 0.) {
+			ErrorModelTube(FileName, iTb, " wrong outlet orifice diameter");
+		}
+		_tube& iTube = Tubes[iTb];
+		iTube.Number = iTb;
+		iTube.PointIn = Record.PointIn;
+		iTube.PointOut = Record.PointOut;
+		iTube.Dia = Record.Dia;
+		iTube.area = Record.area;
+		iTube.RadiusBend = Record.RadiusBend;
+		iTube.Height = Record.Height;
+		iTube.Length = Record.Length;
+		if (iTube.RadiusBend >= 1e-6) {
+			_tubeOutput& iTubeOut = TubesOutput[iTb];
+			iTubeOut.OCSStartAngle = Record.OCSStartAngle;
+			iTubeOut.OCSEndAngle = Record.OCSEndAngle;
+			iTubeOut.OCSCenterX = Record.OCSCenterX;
+			iTubeOut.OCSCenterY = Record.OCSCenterY;
+			iTubeOut.OCSCenterZ = Record.OCSCenterZ;
+			iTubeOut.Nx = Record.Nx;
+			iTubeOut.Ny = Record.Ny;
+			iTubeOut.Nz = Record.Nz;
+			iTube.beta = Record.beta;
+		}
+		iTube.q = Record.q;
+		iTube.NoParallel = Record.NoParallel;
+		iTube.ksiAdd = Record.ksiAdd;
+		iTube.FactHeat = Record.FactHeat;
+		iTube.DiaOrificeIn = Record.DiaOrificeIn;
+		iTube.DiaOrificeOut = Record.DiaOrificeOut;
+		iTube.EnthInGiven = Record.EnthInGiven;
+		iTube.HeatFlux = iTube.q /
+			(M_PI * iTube.Dia * iTube.Length * iTube.NoParallel);
+		Points[iTube.PointIn].NoTb++;
+		Points[iTube.PointIn].NbTb.push_back(iTb);
+		Points[iTube.PointOut].NoTb++;
+		Points[iTube.PointOut].NbTb.push_back(iTb);
+		Drum.qSum += iTube.q;
+	}
+
+	/**
+	 * 5.) names of the tubes
+	 */
+	const char* NamesEnd = Position + Header.SizeNames;
+	for (size_t iTb = 0; iTb <= mTb; ++iTb) {
+		uint32_t Length;
+		if (NamesEnd - Position < static_cast<ptrdiff_t>(sizeof(Length))) {
+			ErrorModel(FileName, "file is damaged (names of tubes)");
+		}
+		take(Position, Length);
+		if (Length > static_cast<uint64_t>(NamesEnd - Position)) {
+			ErrorModel(FileName, "file is damaged (names of tubes)");
+		}
+		TubesOutput[iTb].Name.assign(Position, Length);
+		Position += Length;
+	}
+	Position = NamesEnd;
+	setDowncomerLevel(LevelHighestPoint, LevelLowestPoint);
+
+	/**
+	 * 6.) the mesh, if there is one and it was determined from this input by this program version\n
+	 * otherwise Mesh() determines it
+	 */
+	if (Header.SizeMesh > 0) {
+		Topology.isValid = readMesh(Position, Header.SizeMesh, Header, Topology);
+		if (Topology.isValid) {
+			prot << "\n mesh read from binary model file";
+		}
+		else {
+			Topology = _meshTopology();
+			prot << "\n mesh in binary model file not usable, it is determined again";
+		}
+	}
+	return;
+}
+
+string modelInput() {
+	_wscbHeader Header{};
+	_wscbBase BaseData{};
+	string Input(sizeof(_wscbHeader), '\0');
+
+	memcpy(Header.Id, WscbId, sizeof(WscbId));
+	Header.Version = WscbVersion;
+	Header.ByteOrder = WscbByteOrder;
+	Header.NoPoints = Points.size();
+	Header.NoTubes = Tubes.size();
+
+	BaseData.maxit = Base.maxit;
+	BaseData.Control = Base.Control;
+	BaseData.Method = Base.Method;
+	BaseData.tol = Base.tol;
+	BaseData.pMPa = Drum.pMPa;
+	BaseData.Rough = Base.Rough;
+	BaseData.LevelFact = Base.LevelFact;
+	BaseData.LevelW = Drum.LevelW;
+	BaseData.dpDyn = Drum.dpDyn;
+	BaseData.CRStart = Base.CRStart;
+	append(Input, BaseData);
+
+	for (const auto& iPoint : Points) {
+		_wscbPoint Record{ iPoint.Number, iPoint.xCoord, iPoint.yCoord, iPoint.zCoord };
+		append(Input, Record);
+	}
+	for (size_t iTb = 0; iTb < Tubes.size(); ++iTb) {
+		const _tube& iTube = Tubes[iTb];
+		const _tubeOutput& iTubeOut = TubesOutput[iTb];
+		_wscbTube Record{};
+		Record.Number = iTube.Number;
+		Record.PointIn = iTube.PointIn;
+		Record.PointOut = iTube.PointOut;
+		Record.Dia = iTube.Dia;
+		Record.area = iTube.area;
+		Record.Length = iTube.Length;
+		Record.Height = iTube.Height;
+		Record.beta = iTube.beta;
+		Record.RadiusBend = iTube.RadiusBend;
+		Record.NoParallel = iTube.NoParallel;
+		Record.ksiAdd = iTube.ksiAdd;
+		Record.q = iTube.q;
+		Record.FactHeat = iTube.FactHeat;
+		Record.DiaOrificeIn = iTube.DiaOrificeIn;
+		Record.DiaOrificeOut = iTube.DiaOrificeOut;
+		Record.EnthInGiven = iTube.EnthInGiven;
+		Record.OCSStartAngle = iTubeOut.OCSStartAngle;
+		Record.OCSEndAngle = iTubeOut.OCSEndAngle;
+		Record.OCSCenterX = iTubeOut.OCSCenterX;
+		Record.OCSCenterY = iTubeOut.OCSCenterY;
+		Record.OCSCenterZ = iTubeOut.OCSCenterZ;
+		Record.Nx = iTubeOut.Nx;
+		Record.Ny = iTubeOut.Ny;
+		Record.Nz = iTubeOut.Nz;
+		append(Input, Record);
+	}
+	size_t NamesBegin = Input.size();
+	for (const auto& iTubeOut : TubesOutput) {
+		uint32_t Length = static_cast<uint32_t>(iTubeOut.Name.size());
+		append(Input, Length);
+		Input += iTubeOut.Name;
+	}
+	Input.resize((Input.size() + 7) / 8 * 8, '\0');
+	Header.SizeNames = Input.size() - NamesBegin;
+	Header.InputHash = wscbHash(Input.data() + sizeof(_wscbHeader), Input.size() - sizeof(_wscbHeader));
+	memcpy(&Input[0], &Header, sizeof(_wscbHeader));
+	return Input;
+}
+
+void saveModel(const string& Input, const _meshTopology& Topology) {
+	string FileName = PathFile + ".wscb";
+	string TempName = FileName + ".tmp";
+	_wscbHeader Header;
+	_wscbMesh Head{};
+	string Mesh;
+
+	if (!wscbIsLittleEndian() || !Topology.isValid) return;
+	memcpy(&Header, Input.data(), sizeof(_wscbHeader));
+	Head.MeshVersion = WscbMeshVersion;
+	Head.InputHash = Header.InputHash;
+	Head.NoNodes = Topology.NodesMeshed.size();
+	Head.NoBranches = Topology.BranchesMeshed.size();
+
+	/// the records of tubes, nodes and branches, then the lists
+	for (size_t iTb = 0; iTb < Topology.isReversed.size(); ++iTb) {
+		_wscbMeshTube Record{ Topology.isReversed[iTb], static_cast<uint64_t>(Topology.UorS[iTb]), Topology.beta[iTb] };
+		append(Mesh, Record);
+	}
+	for (const auto& iNode : Topology.NodesMeshed) {
+		_wscbNode Record{};
+		Record.NbPt = iNode.NbPt;
+		Record.Elev = iNode.Elev;
+		Record.NoBr = iNode.NbBr.size();
+		Record.NoBrArrive = iNode.NbBrArrive.size();
+		Record.NoBrLeave = iNode.NbBrLeave.size();
+		Record.IsT = iNode.IsT;
+		Record.NbTbTStraight[0] = iNode.NbTbTStraight[0];
+		Record.NbTbTStraight[1] = iNode.NbTbTStraight[1];
+		Record.NbTbTOff = iNode.NbTbTOff;
+		Record.NbBrTStraight[0] = iNode.NbBrTStraight[0];
+		Record.NbBrTStraight[1] = iNode.NbBrTStraight[1];
+		Record.NbBrTOff = iNode.NbBrTOff;
+		Record.TOrientation = static_cast<uint64_t>(iNode.TOrientation);
+		memcpy(Record.AngleT, iNode.AngleT, sizeof(Record.AngleT));
+		append(Mesh, Record);
+	}
+	for (const auto& iBranch : Topology.BranchesMeshed) {
+		_wscbBranch Record{ iBranch.NbPtIn, iBranch.NbPtOut, iBranch.NbNdIn, iBranch.NbNdOut, iBranch.NbTbInBr.size() };
+		append(Mesh, Record);
+	}
+	size_t ListBegin = Mesh.size();
+	auto appendList = [&Mesh](const stVector& List) {
+		for (uint64_t iEntry : List) {
+			append(Mesh, iEntry);
+		}
+	};
+	for (const auto& iList : Topology.PointTubes) {
+		appendList(iList);
+	}
+	for (const auto& iNode : Topology.NodesMeshed) {
+		appendList(iNode.NbBr);
+		appendList(iNode.NbBrArrive);
+		appendList(iNode.NbBrLeave);
+	}
+	for (const auto& iBranch : Topology.BranchesMeshed) {
+		appendList(iBranch.NbTbInBr);
+	}
+	Head.NoLinks = (Mesh.size() - ListBegin) / sizeof(uint64_t);
+	Head.MeshHash = wscbHash(Mesh.data(), Mesh.size());
+	Header.SizeMesh = sizeof(_wscbMesh) + Mesh.size();
+
+	/// written to a temporary file first, an interrupted calculation does not leave a damaged model file
+	{
+		ofstream outModel(TempName.c_str(), ios::binary);
+		outModel.write(reinterpret_cast<const char*>(&Header), sizeof(_wscbHeader));
+		outModel.write(Input.data() + sizeof(_wscbHeader), Input.size() - sizeof(_wscbHeader));
+		outModel.write(reinterpret_cast<const char*>(&Head), sizeof(_wscbMesh));
+		outModel.write(Mesh.data(), Mesh.size());
+		if (!outModel.good()) {
+			cout << "\n cannot write binary model file " << TempName << endl;
+			prot << "\n cannot write binary model file " << TempName << endl;
+			return;
+		}
+	}
+	error_code ec;
+	filesystem::rename(TempName, FileName, ec);
+	if (ec) {
+		cout << "\n " << FileName << " : " << ec.message() << endl;
+		prot << "\n " << FileName << " : " << ec.message() << endl;
+		filesystem::remove(TempName, ec);
+		return;
+	}
+	prot << "\n input and mesh saved to binary model file " << FileName << "\n";
+	return;
+}
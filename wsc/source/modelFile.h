@@ -0,0 +1,190 @@
+/*****************************************************************//**
+ * \file   modelFile.h
+ * \brief layout of the binary model file (*projectname*.wscb), shared by dxf2wsc and wsc
+ *
+ * dxf2wsc writes it (option --wscb) instead of the rounded text of the .dat file, wsc reads it and adds the mesh determined by Mesh().\n
+ * little-endian, all records are multiples of 8 bytes, so every record starts 8 byte aligned:\n
+ * _wscbHeader\n
+ * _wscbBase: base data\n
+ * _wscbPoint for each point (index = point number)\n
+ * _wscbTube for each tube (index = tube number) with the geometry of wscbGeometry()\n
+ * names of the tubes: for each tube uint32 length and the characters, the block is padded with 0 to a multiple of 8 bytes\n
+ * optional mesh (SizeMesh > 0): _wscbMesh, _wscbMeshTube for each tube, _wscbNode for each node, _wscbBranch for each branch,
+ * then the lists as uint64: for each point its tubes in the order of the input, for each node its branches, arriving and leaving branches,
+ * for each branch its tubes\n
+ * without mesh the tubes of a point are in the order of the tube numbers\n
+ * InputHash is the hash of base data, points, tubes and names, the mesh is only valid for the input it was determined from
+ *
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#ifndef _MODELFILE_H
+#define _MODELFILE_H
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+static const char WscbId[8] = "WSCBIN";
+static const uint32_t WscbVersion = 1;        ///< version of the layout
+static const uint32_t WscbMeshVersion = 1;    ///< version of the mesh determination, a mesh of another version is determined again
+static const uint32_t WscbByteOrder = 0x01020304;
+
+/// first record of the file
+struct _wscbHeader {
+	char Id[8];         ///< WscbId
+	uint32_t Version;   ///< WscbVersion
+	uint32_t ByteOrder; ///< WscbByteOrder, as written by a little-endian computer
+	uint64_t NoPoints;  ///< number of points (highest point number + 1)
+	uint64_t NoTubes;   ///< number of tubes (highest tube number + 1)
+	uint64_t SizeNames; ///< size of the block of tube names [bytes]
+	uint64_t InputHash; ///< hash of base data, points, tubes and names
+	uint64_t SizeMesh;  ///< size of the mesh block [bytes], 0: no mesh
+};
+
+/// base data, units as used in wsc
+struct _wscbBase {
+	int64_t maxit;    ///< maximum flow iterations
+	int64_t Control;  ///< control number for the protocol file
+	int64_t Method;   ///< calculation method (character)
+	double tol;       ///< tolerance
+	double pMPa;      ///< drum pressure [MPa] (absolute)
+	double Rough;     ///< tube roughness [m]
+	double LevelFact; ///< factor for the level between highest and lowest point downcomers have to pass [-]
+	double LevelW;    ///< water level in drum relative to drum center [mm]
+	double dpDyn;     ///< pressure drop of drum internals [Pa]
+	double CRStart;   ///< initial guess of circulation ratio
+};
+
+/// point, coordinates in mm
+struct _wscbPoint {
+	uint64_t Number; ///< point number, MINUS1 if not used
+	double xCoord;
+	double yCoord;
+	double zCoord;
+};
+
+/// tube, units as in class _tube of wsc (m), OCS data of bends in mm and deg
+struct _wscbTube {
+	uint64_t Number;   ///< tube number, MINUS1 if not used
+	uint64_t PointIn;
+	uint64_t PointOut;
+	double Dia;        ///< inside diameter [m]
+	double area;       ///< cross section area [m2]
+	double Length;     ///< length [m]
+	double Height;     ///< height [m]
+	double beta;       ///< angle of bend [deg], 0 for straight tubes
+	double RadiusBend; ///< radius of bend [m]
+	double NoParallel;
+	double ksiAdd;
+	double q;          ///< heat absorption of all parallel tubes [kW]
+	double FactHeat;
+	double DiaOrificeIn;  ///< [m]
+	double DiaOrificeOut; ///< [m]
+	double EnthInGiven;
+	double OCSStartAngle;
+	double OCSEndAngle;
+	double OCSCenterX;
+	double OCSCenterY;
+	double OCSCenterZ;
+	double Nx;
+	double Ny;
+	double Nz;
+};
+
+/// head of the mesh block
+struct _wscbMesh {
+	uint32_t MeshVersion; ///< WscbMeshVersion
+	uint32_t Reserved;
+	uint64_t InputHash;   ///< InputHash of the input the mesh was determined from
+	uint64_t NoNodes;
+	uint64_t NoBranches;
+	uint64_t NoLinks;     ///< number of entries of the lists
+	uint64_t MeshHash;    ///< hash of the mesh block after this record
+};
+
+/// tube in mesh
+struct _wscbMeshTube {
+	uint64_t isReversed; ///< 1: the direction was reversed to the direction of its branch
+	uint64_t UorS;       ///< USArrangement
+	double beta;         ///< angle to preceding tube or of bend [deg]
+};
+
+/// node, the Tee data as determined by determineTee()
+struct _wscbNode {
+	uint64_t NbPt;
+	double Elev;
+	uint64_t NoBr;
+	uint64_t NoBrArrive;
+	uint64_t NoBrLeave;
+	uint64_t IsT;
+	uint64_t NbTbTStraight[2];
+	uint64_t NbTbTOff;
+	uint64_t NbBrTStraight[2];
+	uint64_t NbBrTOff;
+	uint64_t TOrientation; ///< TeeOrientation
+	double AngleT[3][2];
+};
+
+/// branch, as determined before the start values
+struct _wscbBranch {
+	uint64_t NbPtIn;
+	uint64_t NbPtOut;
+	uint64_t NbNdIn;
+	uint64_t NbNdOut;
+	uint64_t NoTubes;
+};
+
+static_assert(sizeof(_wscbHeader) == 56 && sizeof(_wscbBase) == 80 && sizeof(_wscbPoint) == 32 && sizeof(_wscbTube) == 192 &&
+	sizeof(_wscbMesh) == 48 && sizeof(_wscbMeshTube) == 24 && sizeof(_wscbNode) == 152 && sizeof(_wscbBranch) == 40,
+	"records of .wscb file without padding");
+
+/// true if this computer stores numbers little-endian, as in the file
+inline bool wscbIsLittleEndian() {
+	uint32_t Order = WscbByteOrder;
+	unsigned char First;
+	memcpy(&First, &Order, 1);
+	return First == 0x04;
+}
+
+/// hash (FNV-1a on 8 byte words) of Size bytes, Size is a multiple of 8
+inline uint64_t wscbHash(const char* Data, uint64_t Size) {
+	uint64_t hash = 14695981039346656037ull;
+	for (uint64_t i = 0; i + 8 <= Size; i += 8) {
+		uint64_t Word;
+		memcpy(&Word, Data + i, 8);
+		hash ^= Word;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/**
+ * \brief geometry of a tube from the data in mm (as in .dxf and .dat file), the same calculation in dxf2wsc and wsc
+ *
+ * \param dOut outside diameter [mm]
+ * \param Thickness wall thickness [mm]
+ * \param BendRadius radius of bend [mm], 0 for straight tube
+ * \param dx, dy, dz difference of coordinates between outlet and inlet point [mm]
+ * \param StartAngle, EndAngle start and end angle of bend [deg]
+ * \param [out] Tube Dia, area, RadiusBend, Height, Length and beta are set
+ */
+inline void wscbGeometry(double dOut, double Thickness, double BendRadius, double dx, double dy, double dz,
+	double StartAngle, double EndAngle, _wscbTube& Tube) {
+	const double Pi = 3.14159265358979323846;
+	Tube.Dia = (dOut - Thickness * 2.) / 1e3; // ->m
+	Tube.area = Pi / 4. * (Tube.Dia * Tube.Dia);// ->m2
+	Tube.RadiusBend = BendRadius / 1e3;   /* -> m */
+	Tube.Height = dz / 1e3; // ->m
+	if (Tube.RadiusBend < 1e-6) {
+		Tube.beta = 0.;
+		Tube.Length = sqrt(dx * dx + dy * dy + dz * dz) / 1e3;// ->m
+	}
+	else {
+		Tube.beta = EndAngle - StartAngle; //in deg
+		if (Tube.beta < 0.) Tube.beta += 360.;
+		Tube.Length = Tube.beta * Pi / 180. * Tube.RadiusBend;// in m
+	}
+}
+
+#endif
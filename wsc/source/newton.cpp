@@ -0,0 +1,100 @@
+/*****************************************************************//**
+ * \file   newton.cpp
+ * \brief  step length control for the Newton solver of the flow in branches
+ *
+ * with dPLinear being the derivative of the pressure difference in the branch (tangent, see dpBranch)
+ * the flow gNew from CalcPressureNodes is the Newton step of the coupled system\n
+ * branch momentum: pIn - pOut = dp(g) and mass balance in all nodes\n
+ * (the branch flows eliminated, the equation system for the nodal pressures is the Schur complement of the Jacobian)\n
+ * the enthalpies in the nodes are taken from the current flow (not part of the Jacobian)
+ *
+ * the full step is used as long as the Newton correction decreases (natural monotonicity test),
+ * otherwise the step of the last iteration is repeated with half the length
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#undef MAINFUNCTION
+#include "CommonHeader.h"
+
+static const double alphaMin = 1. / 32.; ///< smallest step length, below the step is accepted anyway
+static const double gFractMin = 0.2;     ///< a step may reduce the flow of a branch at most to this fraction (negative flow -> reversal in Step())
+
+// the state of the step length control is kept per thread and belongs to model StepModel
+static thread_local vector<double> gBase;  ///< flow at start of accepted step
+static thread_local vector<double> gDir;   ///< Newton correction of accepted step
+static thread_local double thetaBase = -1.; ///< norm of Newton correction of accepted step, < 0 no step yet
+static thread_local double alpha = 1.;      ///< step length
+static thread_local size_t StepModel = 0;   ///< model of the step length control
+
+void NewtonReset() {
+	thetaBase = -1.;
+	alpha = 1.;
+}
+
+/**
+ * \brief flow of one branch on the step from gBase in direction gDir
+ *
+ * \param iBr number of branch
+ * \param length step length
+ * \return double new flow
+ */
+static double StepFlow(size_t iBr, double length) {
+	double gStep = gBase[iBr] + length * gDir[iBr];
+	if (gStep < gFractMin * gBase[iBr]) gStep = gFractMin * gBase[iBr];
+	if (fabs(gStep) < 1e-5) gStep = 0.;
+	return gStep;
+}
+
+void NewtonUpdate() {
+	if (StepModel != ActiveModel->Id) {
+		NewtonReset();
+		StepModel = ActiveModel->Id;
+	}
+	gBase.resize(mBr + 1);
+	gDir.resize(mBr + 1);
+
+	/// norm of Newton correction: root mean square of the relative change of flow
+	double gMax = 0.;
+	for (const auto& iBranch : Branches) {
+		gMax = fmax(gMax, fabs(iBranch.g));
+	}
+	double gScale = 1e-3 * gMax + 1e-9;
+	double theta = 0.;
+	size_t NoBr = 0;
+	for (const auto& iBranch : Branches) {
+		if (iBranch.isFlowSet2zero) continue;
+		double diff = (iBranch.gNew - iBranch.g) / fmax(fabs(iBranch.g), gScale);
+		theta += diff * diff;
+		NoBr++;
+	}
+	theta = sqrt(theta / static_cast<double>(max(NoBr, size_t(1))));
+
+	bool isRejected = thetaBase >= 0. && theta > (1. - alpha / 4.) * thetaBase && alpha > alphaMin;
+	if (isRejected) {
+		/// correction grew: back to the start of the last step, half the step length
+		alpha /= 2.;
+		for (auto& iBranch : Branches) {
+			iBranch.g = StepFlow(iBranch.Number, alpha);
+		}
+	}
+	else {
+		if (thetaBase >= 0. && theta < thetaBase / 2.) alpha = fmin(1., 2. * alpha);
+		thetaBase = theta;
+		for (auto& iBranch : Branches) {
+			gBase[iBranch.Number] = iBranch.g;
+			gDir[iBranch.Number] = iBranch.gNew - iBranch.g;
+			iBranch.g = StepFlow(iBranch.Number, alpha);
+		}
+	}
+	for (auto& iBranch : Branches) {
+		iBranch.gPrev3 = iBranch.gPrev2;
+		iBranch.gPrev2 = iBranch.gPrev1;
+		iBranch.gPrev1 = gBase[iBranch.Number];
+	}
+	if (Base.showFlow) {
+		prot << "\n Newton iteration " << Base.iterg << " norm of correction " << theta
+			<< (isRejected ? " rejected" : " accepted") << " step length " << alpha << endl;
+	}
+	return;
+}
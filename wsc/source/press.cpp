@@ -29,13 +29,13 @@ int CalcPressureNodes(SparseMatrix<double>& S, /* System sparse matrix */
 		if (!SingleEquation()) {
 			prot << "\nerror in solver of equation " << endl;
 			std::cout << "\nerror in solver of equation " << endl;
-			exit(1);
+			throw _wscError("error in solver of equation");
 		}
 	}
 	else if (!LES(S, B, X)) {
 		prot << "\nerror in solver of equation system " << endl;
 		std::cout << "\nerror in solver of equation system " << endl;
-		exit(1);
+		throw _wscError("error in solver of equation system");
 	}
 
 	if (Base.showNodePressure) {
@@ -71,7 +71,7 @@ int CalcPressureNodes(SparseMatrix<double>& S, /* System sparse matrix */
 			prot << "\nerror in solver of equation system: Flow in node " << iNode.Number << " not balanced" << endl;
 			cout << "\nerror in solver of equation system: Flow in node " << iNode.Number << " not balanced" << endl;
 			prot << "\n Node " << iNode.Number << " gsum " << iNode.gSum;
-			exit(1);
+			throw _wscError("flow in node " + to_string(iNode.Number) + " not balanced");
 		}
 	}
 	//if ( Base.showNodePressure ) {
@@ -85,7 +85,7 @@ static double n3[40] = { 1.0658070028513,-15.732845290239,
 double H2O::gamma1(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double pFact, tFact, pFact_2, pFact_4, tFact_2,
+	double pFact, tFact, pFact_2, pFact_4, tFact_2,
 		tFact_3, tFact_4, tFact_5, tFact_6, tFact_7, tFact_8,
 		tFact_9, pFact_8, tFact_10, tFact_11, tFact_31,
 		tFact_40, tFact_41, tFact_17, tFact_29, tFact_38,
@@ -137,7 +137,7 @@ double H2O::gamma1(double pNorm, double tNorm)
 double H2O::gamma1Tau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double pFact, tFact, pFact_2, pFact_4, tFact_2,
+	double pFact, tFact, pFact_2, pFact_4, tFact_2,
 		tFact_3, tFact_4, tFact_5, tFact_6, tFact_7, tFact_8,
 		tFact_9, pFact_8, tFact_10, tFact_12, tFact_30,
 		tFact_32, tFact_40, tFact_16, tFact_41, tFact_42,
@@ -192,7 +192,7 @@ double H2O::gamma1Tau(double pNorm, double tNorm)
 double H2O::gamma1Pi(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double pFact, tFact, pFact_2, pFact_4, tFact_2,
+	double pFact, tFact, pFact_2, pFact_4, tFact_2,
 		tFact_3, tFact_4, tFact_5, tFact_6, tFact_7, tFact_8,
 		tFact_9, pFact_8, tFact_10, tFact_11, tFact_31,
 		tFact_40, tFact_41, tFact_17, tFact_29, tFact_38,
@@ -242,7 +242,7 @@ double H2O::gamma1Pi(double pNorm, double tNorm)
 double H2O::gamma1PiPi(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double pFact, tFact, pFact_2, pFact_4, tFact_2,
+	double pFact, tFact, pFact_2, pFact_4, tFact_2,
 		tFact_3, tFact_4, tFact_5, tFact_6, tFact_7, tFact_8,
 		tFact_9, pFact_8, tFact_10, tFact_11, tFact_31,
 		tFact_40, tFact_41, tFact_17, tFact_29, tFact_38,
@@ -290,7 +290,7 @@ double H2O::gamma1PiPi(double pNorm, double tNorm)
 double H2O::gamma1TauTau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double pFact, tFact, pFact_2, pFact_4, tFact_2,
+	double pFact, tFact, pFact_2, pFact_4, tFact_2,
 		tFact_3, tFact_4, tFact_5, tFact_6, tFact_7, tFact_8,
 		tFact_9, pFact_8, tFact_10, tFact_11, tFact_13,
 		tFact_31, tFact_15, tFact_33, tFact_40, tFact_41,
@@ -343,7 +343,7 @@ double H2O::gamma1TauTau(double pNorm, double tNorm)
 double H2O::gamma1PiTau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double pFact, tFact, pFact_2, pFact_4, tFact_2,
+	double pFact, tFact, pFact_2, pFact_4, tFact_2,
 		tFact_3, tFact_4, tFact_5, tFact_6, tFact_7, tFact_8,
 		tFact_9, pFact_8, tFact_10, tFact_12, tFact_30,
 		tFact_32, tFact_40, tFact_16, tFact_41, tFact_42,
@@ -431,7 +431,7 @@ double H2O::gamma2(double pNorm, double tNorm)
 double H2O::gamma2rPi(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
+	double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
 		tFact_4, tFact_6, tFact_7, tFact_8, tFact_10,
 		tFact_11, tFact_20, tFact_13, tFact_14, tFact_21,
 		tFact_16, tFact_25, tFact_26, tFact_35, tFact_29,
@@ -509,7 +509,7 @@ double H2O::gamma2Pi(double pNorm, double tNorm)
 double H2O::gamma2rPiTau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
+	double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
 		tFact_5, tFact_6, tFact_7, tFact_9, tFact_10,
 		tFact_20, tFact_12, tFact_13, tFact_15, tFact_24,
 		tFact_25, tFact_34, tFact_19, tFact_28, tFact_35,
@@ -585,7 +585,7 @@ double H2O::gamma2PiTau(double pNorm, double tNorm)
 double H2O::gamma2rPiPi(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
+	double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
 		tFact_4, tFact_6, tFact_7, tFact_8, tFact_10,
 		tFact_11, tFact_20, tFact_13, tFact_14, tFact_21,
 		tFact_16, tFact_25, tFact_26, tFact_35, tFact_29,
@@ -661,7 +661,7 @@ double H2O::gamma2PiPi(double pNorm, double tNorm)
 double H2O::gamma2rTau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
+	double tFact, pFact_2, pFact_4, tFact_2, tFact_3,
 		tFact_4, tFact_5, tFact_6, tFact_7, tFact_9, tFact_10,
 		tFact_20, tFact_12, tFact_13, tFact_15, tFact_24,
 		tFact_25, tFact_34, tFact_19, tFact_28, tFact_35,
@@ -727,7 +727,7 @@ double H2O::gamma2rTau(double pNorm, double tNorm)
 double H2O::gamma2Tau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double gamma0, ktNorm;
+	double gamma0, ktNorm;
 
 	ktNorm = 1. / tNorm;
 	gamma0 = tNorm * tNorm * (n0gamma2[8] * 3. + ktNorm * (n0gamma2[7] * 2.
@@ -743,7 +743,7 @@ double H2O::gamma2Tau(double pNorm, double tNorm)
 double H2O::gamma2rTauTau(double pNorm, double tNorm)
 {
 	double ret_val;
-	static double tFact, pFact_2, pFact_4, tFact_2, tFact_4,
+	double tFact, pFact_2, pFact_4, tFact_2, tFact_4,
 		tFact_5, tFact_6, tFact_8, tFact_9, tFact_11,
 		tFact_12, tFact_14, tFact_23, tFact_24, tFact_33,
 		tFact_18, tFact_19, tFact_27, tFact_34, tFact_37,
@@ -822,7 +822,7 @@ double H2O::gamma2TauTau(double pNorm, double tNorm)
 double H2O::phi3(double rhoNorm, double tNorm)
 {
 	double ret_val;
-	static double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
+	double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
 		tNorm_10, tNorm_12, tNorm_22, tNorm_23, tNorm_15,
 		tNorm_16, tNorm_17, tNorm_26;
 
@@ -861,7 +861,7 @@ double H2O::phi3(double rhoNorm, double tNorm)
 double H2O::phi3Delta(double rhoNorm, double tNorm)
 {
 	double ret_val;
-	static double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
+	double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
 		tNorm_10, tNorm_12, tNorm_22, tNorm_23, tNorm_15,
 		tNorm_16, tNorm_17, tNorm_26;
 
@@ -899,7 +899,7 @@ double H2O::phi3Delta(double rhoNorm, double tNorm)
 double H2O::phi3Tau(double rhoNorm, double tNorm)
 {
 	double ret_val;
-	static double tNorm_1, tNorm_2, tNorm_3, tNorm_5, tNorm_6,
+	double tNorm_1, tNorm_2, tNorm_3, tNorm_5, tNorm_6,
 		tNorm_9, tNorm_11, tNorm_21, tNorm_22, tNorm_14,
 		tNorm_15, tNorm_16, tNorm_25;
 
@@ -948,7 +948,7 @@ double H2O::phi3Tau(double rhoNorm, double tNorm)
 double H2O::phi3TauTau(double rhoNorm, double tNorm)
 {
 	double ret_val;
-	static double tNorm_1, tNorm_2, tNorm_4, tNorm_5, tNorm_8,
+	double tNorm_1, tNorm_2, tNorm_4, tNorm_5, tNorm_8,
 		tNorm_10, tNorm_20, tNorm_21, tNorm_13, tNorm_14,
 		tNorm_15, tNorm_24;
 
@@ -993,7 +993,7 @@ double H2O::phi3TauTau(double rhoNorm, double tNorm)
 double H2O::phi3DeltaTau(double rhoNorm, double tNorm)
 {
 	double ret_val;
-	static double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
+	double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
 		tNorm_10, tNorm_12, tNorm_22, tNorm_23, tNorm_15,
 		tNorm_16, tNorm_17, tNorm_26;
 
@@ -1041,7 +1041,7 @@ double H2O::phi3DeltaTau(double rhoNorm, double tNorm)
 double H2O::phi3DeltaDelta(double rhoNorm, double tNorm)
 {
 	double ret_val;
-	static double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
+	double tNorm_2, tNorm_3, tNorm_4, tNorm_6, tNorm_7,
 		tNorm_10, tNorm_12, tNorm_22, tNorm_23, tNorm_15,
 		tNorm_16, tNorm_26;
 
@@ -1166,7 +1166,7 @@ double H2O::enth(double tK, double pMPa, int medium)
 			if (tK < 273.15) {
 				cout << "\nError in H2O.enthalpy t < 0 degC" << endl;
 				prot << "\nError in H2O.enthalpy t < 0 degC" << endl;
-				exit(1);
+				throw _wscError("H2O.enthalpy t < 0 degC");
 				//            return 0.;
 			}
 			pNorm = pMPa / 16.53;
@@ -1207,7 +1207,7 @@ double H2O::enth(double tK, double pMPa, int medium)
 			if (tK < 273.15) {
 				cout << "\nError in H2O.enthalpy t < 0 degC" << endl;
 				prot << "\nError in H2O.enthalpy t < 0 degC" << endl;
-				exit(1);
+				throw _wscError("H2O.enthalpy t < 0 degC");
 				//            return 0.;
 			}
 			else if (tK < 623.15) {  // 350+273.15
@@ -1261,7 +1261,7 @@ double H2O::enth(double tK, double pMPa, int medium)
 		}
 		else {
 			cout << "\nError in H2O.enthalpy t < 0 degC" << endl;
-			exit(1);
+			throw _wscError("H2O.enthalpy t < 0 degC");
 		}
 	}
 	//   return ret_val;
@@ -2341,6 +2341,84 @@ double H2O::SoS(double tK, double pMPa, int medium)
 } /* SoS_H2O__ */
 
 
+/* +++++++++++++++++++++++++++++++++++++++++++++ */
+/*   backward equation T(p,h) for region 3       */
+/*   return value: tK in K                       */
+/*   Source :                                    */
+/*   IAPWS SR3-03(2014), Revised Supplementary   */
+/*   Release on Backward Equations for the       */
+/*   Functions T(p,h), v(p,h) and T(p,s), v(p,s) */
+/*   for Region 3                                */
+/* +++++++++++++++++++++++++++++++++++++++++++++ */
+double H2O::temp3Backward(double ha, double pMPa)
+{
+	static const int I3a[31] = { -12,-12,-12,-12,-12,-12,-12,-12,-10,-10,
+		-10,-8,-8,-8,-8,-5,-3,-2,-2,-2,-1,-1,0,0,1,3,3,4,4,10,12 };
+	static const int J3a[31] = { 0,1,2,6,14,16,20,22,1,5,12,0,2,4,10,2,0,1,3,
+		4,0,2,0,1,1,0,1,0,3,4,5 };
+	static const double n3a[31] = { -1.33645667811215e-7,4.55912656802978e-6,
+		-1.46294640700979e-5,.0063934131297008,372.783927268847,
+		-7186.54377460447,573494.7521034,-2675693.29111439,
+		-3.34066283302614e-5,-.0245479214069597,47.8087847764996,
+		7.64664131818904e-6,.00128350627676972,.0171219081377331,
+		-8.51007304583213,-.0136513461629781,-3.84460997596657e-6,
+		.00337423807911655,-.551624873066791,.72920227710747,
+		-.00992522757376041,-.119308831407288,.793929190615421,
+		.454270731799386,.20999859125991,-.00642109823904738,
+		-.023515586860454,.00252233108341612,-.00764885133368119,
+		.0136176427574291,-.0133027883575669 };
+	static const int I3b[33] = { -12,-12,-10,-10,-10,-10,-10,-8,-8,-8,-8,-8,
+		-6,-6,-6,-4,-4,-3,-2,-2,-1,-1,-1,-1,-1,-1,0,0,1,3,5,6,8 };
+	static const int J3b[33] = { 0,1,0,1,5,10,12,0,1,2,4,10,0,1,2,0,1,5,0,4,
+		2,4,6,10,14,16,0,2,1,1,1,1,1 };
+	static const double n3b[33] = { 3.2325457364492e-5,-1.27575556587181e-4,
+		-4.75851877356068e-4,.00156183014181602,.105724860113781,
+		-85.8514221132534,724.140095480911,.00296475810273257,
+		-.00592721983365988,-.0126305422818666,-.115716196364853,
+		84.9000969739595,-.0108602260086615,.0154304475328851,
+		.0750455441524466,.0252520973612982,-.0602507901232996,
+		-3.07622221350501,-.0574011959864879,5.03471360939849,
+		-.925081888584834,3.91733882917546,-77.314600713019,
+		9496.71934313005,-1410437.19679409,8491662.30819026,
+		.861095729446704,.32334644281172,.873281936020439,
+		-.436653048526683,.286596714529479,-.131778331276228,
+		.00676682064330275 };
+
+	const int* I;
+	const int* J;
+	const double* n;
+	int NoTerms;
+	double pi1, eta1, tRed;
+	/* boundary between sub-region 3a and 3b */
+	double h3ab = 2014.64004206875 + pMPa * (3.74696550136983 + pMPa * (-.0219921901054187 + pMPa * 8.7513168600995e-5));
+	if (ha <= h3ab) {
+		/* sub-region 3a */
+		pi1 = pMPa / 100. + .24;
+		eta1 = ha / 2300. - .615;
+		tRed = 760.;
+		I = I3a;
+		J = J3a;
+		n = n3a;
+		NoTerms = 31;
+	}
+	else {
+		/* sub-region 3b */
+		pi1 = pMPa / 100. + .298;
+		eta1 = ha / 2800. - .72;
+		tRed = 860.;
+		I = I3b;
+		J = J3b;
+		n = n3b;
+		NoTerms = 33;
+	}
+	double theta = 0.;
+	for (int i = 0; i < NoTerms; ++i) {
+		theta += n[i] * pow(pi1, I[i]) * pow(eta1, J[i]);
+	}
+	return theta * tRed;
+} /* temp3Backward */
+
+
 /* +++++++++++++++++++++++++++++++++++++++++++++ */
 /*   function for calculation of temperatures    */
 /*   at given pressure and enthalpy              */
@@ -2391,19 +2469,20 @@ double H2O::temp(double ha, double pMPa)
 
 	double tBoundary2_3;
 	int i, medium;
-	static double upperh, tK, pi, lowerh, pi1, pi3, pi4, pi7, enth_Boundary,
+	double tK, pi, pi1, pi3, pi4, pi7, enth_Boundary,
 		iterLimit, eta, htK, eta1, eta2, eta3, eta4, eta6, eta7, eta8,
 		eta9, eta10, eta11, eta12, eta20, eta32, eta24, eta34, eta40,
 		eta18, eta28, eta36, eta38, eta42, eta44, eta16, eta22, hdiff,
-		lowerTemp, upperTemp, hdiffu, tSatK, hSatSTEAM, hSatWATER;
+		lowerTemp, upperTemp, tSatK, hSatSTEAM, hSatWATER;
 	double pBoundary;
 
 	iterLimit = 1e-4;
 	/* first check for saturation below critical pressure */
 	if (pMPa < 22.064) {
 		tSatK = satTemp(pMPa);
-		hSatSTEAM = enth(tSatK, pMPa, STEAM);
 		hSatWATER = enth(tSatK, pMPa, WATER);
+		/* enthalpy of saturated steam is only needed above saturated water */
+		hSatSTEAM = ha < hSatWATER ? hSatWATER : enth(tSatK, pMPa, STEAM);
 		if (ha >= hSatWATER && ha <= hSatSTEAM) {
 			/* Saturation */
 			return tSatK;
@@ -2446,8 +2525,8 @@ double H2O::temp(double ha, double pMPa)
 									eta44 + pi * (nda[28] * eta32 + nda[29] * eta36 +
 										nda[30] * eta42 + pi * (nda[31] * eta34 + nda[32] * eta44
 											+ pi * nda[33] * eta28))))));
-				lowerTemp = tK - .00911;
-				upperTemp = tK + .00923;
+				lowerTemp = tSatK;
+				upperTemp = 2273.15;
 				medium = STEAM;
 			}
 			else {
@@ -2509,8 +2588,8 @@ double H2O::temp(double ha, double pMPa)
 											ndc[20] * eta16 + ndc[21] * eta20 + ndc[22] * eta22)))
 									)))))) / pi7;
 				}
-				lowerTemp = tK - .019;
-				upperTemp = tK + .022;
+				lowerTemp = tSatK;
+				upperTemp = 2273.15;
 				medium = STEAM;
 			}
 		}
@@ -2531,8 +2610,8 @@ double H2O::temp(double ha, double pMPa)
 					eta32 + pi * (nw[13] * eta10 + nw[14] * eta32 + pi * (
 						nw[15] * eta10 + eta32 * (nw[16] + pi * (nw[17] + pi *
 							(nw[18] + pi * nw[19]))))));
-			lowerTemp = tK - .0235;
-			upperTemp = tK + .0235;
+			lowerTemp = 273.15;
+			upperTemp = tSatK;
 			medium = WATER;
 		}
 	}
@@ -2558,8 +2637,8 @@ double H2O::temp(double ha, double pMPa)
 					* eta2 + nw[11] * eta10 + nw[12] * eta32 + pi * (nw[13] *
 						eta10 + nw[14] * eta32 + pi * (nw[15] * eta10 + eta32 * (
 							nw[16] + pi * (nw[17] + pi * (nw[18] + pi * nw[19]))))));
-			lowerTemp = tK - .0235;
-			upperTemp = tK + .0235;
+			lowerTemp = 273.15;
+			upperTemp = 623.15;
 			medium = WATER;
 		}
 		else {
@@ -2629,12 +2708,12 @@ double H2O::temp(double ha, double pMPa)
 											ndc[20] * eta16 + ndc[21] * eta20 + ndc[22] * eta22)))
 									)))))) / pi7;
 				}
-				lowerTemp = tK - .019;
-				upperTemp = tK + .022;
+				lowerTemp = tBoundary2_3;
+				upperTemp = 2273.15;
 				medium = STEAM;
 			}
 			else {
-				/*     region 3 */
+				/*     region 3, start value from backward equation T3(p,h) */
 				if (pMPa < 22.064) {
 					if (ha < hSatWATER) {
 						lowerTemp = 623.15;
@@ -2646,70 +2725,21 @@ double H2O::temp(double ha, double pMPa)
 						upperTemp = tBoundary2_3;
 						medium = STEAM;
 					}
-					while (upperTemp - lowerTemp > 1e-6) {
-						tK = (lowerTemp + upperTemp) / 2.;
-						htK = enth(tK, pMPa, medium);
-						hdiff = htK - ha;
-						if (FABS(hdiff) < iterLimit) {
-							return tK;
-						}
-						if (hdiff > 0.) {
-							upperTemp = tK;
-						}
-						else {
-							lowerTemp = tK;
-						}
-					}
 				}
 				else {
 					/* above critical pressure, region 3 */
 					lowerTemp = 623.15;
 					upperTemp = tBoundary2_3;
-					while (upperTemp - lowerTemp > 1e-6) {
-						tK = (lowerTemp + upperTemp) / 2.;
-						htK = enth(tK, pMPa, FLUID);
-						hdiff = htK - ha;
-						if (FABS(hdiff) < iterLimit) {
-							return tK;
-						}
-						if (hdiff > 0.) {
-							upperTemp = tK;
-						}
-						else {
-							lowerTemp = tK;
-						}
-					}
+					medium = FLUID;
 				}
-				return tK;
+				tK = temp3Backward(ha, pMPa);
 			}
 		}
 	}
 
-	htK = enth(tK, pMPa, medium);
-	hdiff = htK - ha;
-	if (FABS(hdiff) < iterLimit) {
-		return tK;
-	}
-	if (hdiff > 0.) {
-		upperTemp = tK;
-		upperh = htK;
-		lowerh = enth(lowerTemp, pMPa, medium);
-		hdiffu = lowerh - ha;
-		if (FABS(hdiffu) < iterLimit) {
-			return lowerTemp;
-		}
-	}
-	else {
-		lowerTemp = tK;
-		lowerh = htK;
-		upperh = enth(upperTemp, pMPa, medium);
-		hdiff = upperh - ha;
-		if (FABS(hdiff) < iterLimit) {
-			return upperTemp;
-		}
-	}
+	/* Newton with cp as derivative, usually 1 or 2 corrections are needed
+	   the solution stays within lowerTemp ... upperTemp, a step leaving this interval is replaced by bisection */
 	for (i = 1; i <= 100; ++i) {
-		tK = upperTemp - hdiff * (upperTemp - lowerTemp) / (upperh - lowerh);
 		htK = enth(tK, pMPa, medium);
 		hdiff = htK - ha;
 		if (FABS(hdiff) < iterLimit) {
@@ -2717,13 +2747,106 @@ double H2O::temp(double ha, double pMPa)
 		}
 		if (hdiff > 0.) {
 			upperTemp = tK;
-			upperh = htK;
 		}
 		else {
 			lowerTemp = tK;
-			lowerh = htK;
+		}
+		if (upperTemp - lowerTemp < 1e-6) {
+			return tK;
+		}
+		tK -= hdiff / cp(tK, pMPa, medium);
+		if (!(tK > lowerTemp && tK < upperTemp)) {
+			tK = (lowerTemp + upperTemp) / 2.;
 		}
 	}
 	return tK;
 } /* temp_H2O__ */
 
+
+/* +++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+/*    properties at saturation for given pressure        */
+/*    calculated directly (no cache)                     */
+/*    Parameter :                                        */
+/*    pMPa: pressure in MPa                              */
+/*    Return :                                           */
+/*    saturation state, surface tension in N/m           */
+/* +++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+SaturationState H2O::satStateDirect(double pMPa)
+{
+	SaturationState Sat;
+
+	Sat.tSat = satTemp(pMPa);
+	Sat.volW = specVol(Sat.tSat, pMPa, WATER);
+	Sat.volS = specVol(Sat.tSat, pMPa, STEAM);
+	Sat.SurfTens = sigma(Sat.tSat) / 1000.;
+	Sat.dynVisW = dynVisc(Sat.tSat, Sat.volW);
+	Sat.dynVisS = dynVisc(Sat.tSat, Sat.volS);
+	Sat.enthW = enth(Sat.tSat, pMPa, WATER);
+	Sat.enthS = enth(Sat.tSat, pMPa, STEAM);
+	return Sat;
+} /* satStateDirect */
+
+/* +++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+/*    properties at saturation for given pressure        */
+/*    grid points every SatGridPa are kept in a table    */
+/*    (one per thread, open addressing, overwritten on   */
+/*    collision), values in between are interpolated     */
+/*    linearly                                           */
+/*    Parameter :                                        */
+/*    pMPa: pressure in MPa                              */
+/*    Return :                                           */
+/*    saturation state, surface tension in N/m           */
+/* +++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+SaturationState H2O::satState(double pMPa)
+{
+	const size_t SatCacheSize = 1024; // power of 2
+	const size_t SatProbes = 4; // slots looked at before overwriting
+	struct SatCacheEntry {
+		long long key = -1; // index of grid point
+		SaturationState Sat;
+	};
+	static thread_local SatCacheEntry SatCache[SatCacheSize];
+
+	double pPa = pMPa * 1e6;
+	if (pPa < SatGridPa || pPa + SatGridPa > 22.064e6) {
+		return satStateDirect(pMPa);
+	}
+	long long k0 = static_cast<long long>(pPa / SatGridPa);
+	double frac = pPa / SatGridPa - static_cast<double>(k0);
+	if (k0 * SatGridPa * 1e-6 <= 16.5292 && (k0 + 1) * SatGridPa * 1e-6 > 16.5292) { // border region 1,2 -> 3 in between
+		return satStateDirect(pMPa);
+	}
+
+	SaturationState Grid[2];
+	for (long long ik = 0; ik < 2; ik++) {
+		long long key = k0 + ik;
+		size_t home = static_cast<size_t>(key * 0x9E3779B97F4A7C15ULL >> 32) & (SatCacheSize - 1);
+		SatCacheEntry* slot = nullptr;
+		for (size_t iProbe = 0; iProbe < SatProbes; iProbe++) {
+			SatCacheEntry* entry = &SatCache[(home + iProbe) & (SatCacheSize - 1)];
+			if (entry->key == key) {
+				slot = entry;
+				break;
+			}
+			if (entry->key < 0 && slot == nullptr) slot = entry;
+		}
+		if (slot == nullptr) slot = &SatCache[home]; // table region full -> overwrite
+		if (slot->key != key) {
+			slot->Sat = satStateDirect(static_cast<double>(key) * SatGridPa * 1e-6);
+			slot->key = key;
+		}
+		Grid[ik] = slot->Sat; // copy, second grid point might overwrite the slot of the first one
+	}
+	const SaturationState& Low = Grid[0];
+	const SaturationState& High = Grid[1];
+	SaturationState Sat;
+	Sat.tSat = Low.tSat + frac * (High.tSat - Low.tSat);
+	Sat.volW = Low.volW + frac * (High.volW - Low.volW);
+	Sat.volS = Low.volS + frac * (High.volS - Low.volS);
+	Sat.SurfTens = Low.SurfTens + frac * (High.SurfTens - Low.SurfTens);
+	Sat.dynVisW = Low.dynVisW + frac * (High.dynVisW - Low.dynVisW);
+	Sat.dynVisS = Low.dynVisS + frac * (High.dynVisS - Low.dynVisS);
+	Sat.enthW = Low.enthW + frac * (High.enthW - Low.enthW);
+	Sat.enthS = Low.enthS + frac * (High.enthS - Low.enthS);
+	return Sat;
+} /* satState */
@@ -17,6 +17,24 @@
 
 using namespace std;
 
+/**
+* @brief properties of water and steam at saturation for one pressure
+*
+* all values that are needed at inlet or outlet of a two-phase section, bundled to be calculated in one call
+ * #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+*/
+struct SaturationState {
+	double tSat = 0.; ///< saturation temperature [K]
+	double volW = 0.; ///< spec. volume of saturated water [m3/kg]
+	double volS = 0.; ///< spec. volume of saturated steam [m3/kg]
+	double SurfTens = 0.; ///< surface tension [N/m]
+	double dynVisW = 0.; ///< dynamic viscosity of saturated water [Pa s]
+	double dynVisS = 0.; ///< dynamic viscosity of saturated steam [Pa s]
+	double enthW = 0.; ///< spec. enthalpy of saturated water [kJ/kg]
+	double enthS = 0.; ///< spec. enthalpy of saturated steam [kJ/kg]
+};
+
 /**
 * @brief calculates properties water and steam
 *
@@ -160,6 +178,35 @@ public:
   */
 	static double sigma(double tSatK);
 
+   /**
+   * @brief properties at saturation for given pressure (cached)
+   *
+   * the properties are stored in a small table per thread for pressures on a grid of SatGridPa\n
+   * in between two grid points the values are interpolated linearly\n
+   * error of interpolation is less than SatGridPa^2/8 * max(second derivative):\n
+   * saturation temperature below 3e-6 K, other values below 3e-7 relative for 0.1 MPa <= p <= 20 MPa (below 1e-9 for p > 1 MPa),
+   * between 20 MPa and the critical point below 3e-6 relative\n
+   * the grid interval containing the border of region 3 (16.5292 MPa) and pressures with p + SatGridPa > 22.064 MPa are calculated directly
+   *
+   * @param pMPa absolute pressure [MPa]
+   * @return SaturationState saturation properties, surface tension in [N/m]
+ * #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+   */
+	static SaturationState satState(double pMPa);
+
+   /**
+   * @brief properties at saturation for given pressure calculated without cache
+   *
+   * @param pMPa absolute pressure [MPa]
+   * @return SaturationState saturation properties, surface tension in [N/m]
+ * #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+   */
+	static SaturationState satStateDirect(double pMPa);
+
+	static constexpr double SatGridPa = 100.; ///< grid distance of cached saturation states [Pa]
+
 private:
 	static double gamma1(double pNorm, double tNorm); /* gamma function in region 1(WATER T<350degC)*/
 	static double gamma1Tau(double pNorm, double tNorm); /* derivative of gamma with respect to tau region 1 */
@@ -189,6 +236,7 @@ private:
 	static double p3_H2O(double tC, double rho);
 	static double approx3_WATER(double pBar, double TempC);
 	static double approx3_STEAM(double pBar, double TempC);
+	static double temp3Backward(double ha, double pMPa); /* backward equation T(p,h) region 3, start value for temp */
 };
 
 //static H2O *h2o = new H2O();
@@ -25,7 +25,7 @@ int saveFlow() {
 	outData.open(writefile.c_str());
 	if (!outData.good()) {
 		cout << "\n cannot open file " << writefile << endl;
-		exit(1);
+		throw _wscError("cannot open file " + writefile);
 	}
 	else {
 		for (const auto& iBranch : Branches) {
@@ -82,6 +82,8 @@ bool Step(void) {
   // to keep mass balance in nodes: if one branch is reversed, use new flow(that
   // is balanced in all nodes) in all branches
   if (IsReverse) {
+    NewtonReset();
+    AndersonReset();
     for (auto& iBranch : Branches) {
       // using the calculated values from mass balance -> no problems with
       // enthalpy calculation
@@ -145,7 +147,7 @@ bool Step(void) {
           if (StartNode.mBrLeave > 0 && EndNode.mBrArrive > 0) {
             cout << "\n branch " << iBranch.Number << " set to zero ";
             prot << "\n branch " << iBranch.Number << " set to zero ";
-            iBranch.isFlowSet2zero = true;
+            iBranch.isFlowSet2zero = true; // stays in the pattern of the equation system, adds nothing (dPLinear = 0)
             iBranch.g = 0.;
             iBranch.dPdyn = 0.;
             iBranch.dPstat = 0.;
@@ -346,6 +348,9 @@ bool Step(void) {
         iBranch.g = iBranch.gNew;
       }
     }
+  } else if (Base.Solver == SolverKind::Newton) {  // no reversal: Newton step with step length control
+    NewtonUpdate();
+  } else if (Base.Solver == SolverKind::Anderson && AndersonUpdate()) {  // no reversal: accelerated step
   } else {  // no reversal: use damping for the new flow
     for (auto& iBranch : Branches) {
       diff1 = fabs((iBranch.g - iBranch.gPrev1) / iBranch.g) * 100.;  // in %
@@ -0,0 +1,410 @@
+/*****************************************************************//**
+ * \file   sweep.cpp
+ * \brief calculation of several load cases of one model in parallel (option --sweep=file)
+ *
+ * case table, one load case per line, lines starting with # are comments:\n
+ * Name pMPa LevelW dpDyn Load [Group=Factor ...]\n
+ * Name: name of the load case (no blanks), used for the protocol file *projectname*_*Name*.pro\n
+ * pMPa: drum pressure [MPa], LevelW: water level in drum [m], dpDyn: pressure drop of drum internals [kPa] (as in .dat file)\n
+ * Load: factor for the heat of all tubes, Group=Factor: additional factor for the heat of all tubes with this name (layer in .dxf file)
+ *
+* \author Rainer_Jordan@<very, very warm>mail.com
+* #### Licence
+* Licensed under the European Union Public Licence (EUPL), Version 1.2 or later
+ *********************************************************************/
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <set>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#undef MAINFUNCTION
+#include "CommonHeader.h"
+
+/// state of a load case in the sweep
+enum class CaseState { Pending, Running, Done };
+
+/// one load case of the case table and its results
+struct SweepCase {
+	string Name;             ///< name of load case
+	double pMPa = 0.;        ///< drum pressure [MPa]
+	double LevelW = 0.;      ///< water level in drum [m]
+	double dpDyn = 0.;       ///< pressure drop of drum internals [kPa]
+	double Load = 1.;        ///< factor for the heat of all tubes
+	vector<pair<string, double>> GroupFactor; ///< additional factor for the heat of tubes with this name
+	vector<double> Param;    ///< parameters of the case for the distance between cases
+
+	CaseState State = CaseState::Pending;
+	size_t Source = MINUS1;  ///< case the calculation started from, MINUS1: flow of initFlow()
+	unique_ptr<_circulationModel> Converged; ///< converged state, start for the neighbouring cases
+	bool isConverged = false;
+	int NoIterations = 0;
+	string Error;            ///< message if the calculation stopped by an error
+	double qSum = 0.;        ///< heat of all tubes [kW]
+	double FlowSteam = 0.;   ///< steam flow [kg/s]
+	double FlowCirc = 0.;    ///< flow of all branches leaving the drum [kg/s]
+	double SafetyMin = 0.;   ///< lowest safety factor of heated tubes
+	double Seconds = 0.;     ///< time of calculation [s]
+
+	/// factor for the heat of tubes named Group
+	double Factor(const string& Group) const {
+		double Factor = Load;
+		for (const auto& iGroup : GroupFactor) {
+			if (iGroup.first == Group) Factor *= iGroup.second;
+		}
+		return Factor;
+	}
+};
+
+/**
+ * reads the case table, the group names have to be names of tubes of the active model
+ */
+static vector<SweepCase> readCaseTable(const string& FileName) {
+	vector<SweepCase> Cases;
+	set<string> Groups;
+	for (const auto& iTubeOut : TubesOutput) {
+		Groups.insert(iTubeOut.Name);
+	}
+	ifstream inData(FileName.c_str());
+	if (!inData.good()) {
+		cout << "\n cannot open case table " << FileName << endl;
+		throw _wscError("cannot open case table " + FileName);
+	}
+	string line;
+	int NbLine = 0;
+	while (getline(inData, line)) {
+		++NbLine;
+		istringstream iss(line);
+		SweepCase Case;
+		if (!(iss >> Case.Name) || Case.Name[0] == '#') continue;
+		string Error;
+		if (!(iss >> Case.pMPa >> Case.LevelW >> Case.dpDyn >> Case.Load)) {
+			Error = "case table line " + to_string(NbLine) + ": Name pMPa LevelW dpDyn Load expected";
+		}
+		else if (Case.pMPa <= 0.1 || Case.pMPa >= 22. || Case.Load <= 0.) {
+			Error = "case table line " + to_string(NbLine) + ": drum pressure or load out of range";
+		}
+		string Token;
+		while (Error.empty() && iss >> Token) {
+			size_t Pos = Token.find('=');
+			double Factor = Pos == string::npos ? 0. : atof(Token.c_str() + Pos + 1);
+			if (Pos == string::npos || Groups.count(Token.substr(0, Pos)) == 0 || Factor <= 0.) {
+				Error = "case table line " + to_string(NbLine) + ": " + Token + " is not Group=Factor of a tube name";
+			}
+			else {
+				Case.GroupFactor.emplace_back(Token.substr(0, Pos), Factor);
+			}
+		}
+		if (!Error.empty()) {
+			cout << "\n " << Error << endl;
+			prot << "\n " << Error << endl;
+			throw _wscError(Error);
+		}
+		Cases.push_back(std::move(Case));
+	}
+	if (Cases.empty()) {
+		cout << "\n no load case in case table " << FileName << endl;
+		throw _wscError("no load case in case table " + FileName);
+	}
+	return Cases;
+}
+
+/**
+ * parameters of all cases for the distance between cases:\n
+ * drum pressure, level, pressure drop of drum internals and heat factor of each group, scaled by their range in the table
+ */
+static void setParameters(vector<SweepCase>& Cases) {
+	set<string> Groups;
+	for (const auto& Case : Cases) {
+		for (const auto& iGroup : Case.GroupFactor) Groups.insert(iGroup.first);
+	}
+	for (auto& Case : Cases) {
+		Case.Param = { Case.pMPa, Case.LevelW, Case.dpDyn, Case.Load };
+		for (const auto& Group : Groups) Case.Param.push_back(Case.Factor(Group));
+	}
+	for (size_t iPar = 0; iPar < Cases[0].Param.size(); ++iPar) {
+		double Min = 1e30, Max = -1e30;
+		for (const auto& Case : Cases) {
+			Min = fmin(Min, Case.Param[iPar]);
+			Max = fmax(Max, Case.Param[iPar]);
+		}
+		for (auto& Case : Cases) {
+			Case.Param[iPar] = Max - Min > 1e-12 ? (Case.Param[iPar] - Min) / (Max - Min) : 0.;
+		}
+	}
+}
+
+static double Distance(const SweepCase& a, const SweepCase& b) {
+	double Sum = 0.;
+	for (size_t iPar = 0; iPar < a.Param.size(); ++iPar) {
+		Sum += (a.Param[iPar] - b.Param[iPar]) * (a.Param[iPar] - b.Param[iPar]);
+	}
+	return sqrt(Sum);
+}
+
+/**
+ * sets drum data and heat of the load case in the active model
+ * \param qBase heat of each tube as read from .dat file [kW]
+ */
+static void applyCase(const SweepCase& Case, const vector<double>& qBase) {
+	double tSatDrum = H2O::satTemp(Case.pMPa);
+	Drum.pMPa = Case.pMPa;
+	Drum.rhoW = 1. / H2O::specVol(tSatDrum, Drum.pMPa, WATER);
+	Drum.enthW = H2O::enth(tSatDrum, Drum.pMPa, WATER);
+	Drum.enthEvap = H2O::enth(tSatDrum, Drum.pMPa, STEAM) - Drum.enthW;
+	Drum.LevelW = Case.LevelW;
+	Drum.dpDyn = Case.dpDyn * 1e3; // conversion to Pa
+	Drum.qSum = 0.;
+	for (auto& iTube : Tubes) {
+		double q = qBase[iTube.Number] * Case.Factor(TubesOutput[iTube.Number].Name);
+		if (iTube.q > 0.) iTube.HeatFlux *= q / iTube.q;
+		iTube.q = q;
+		Drum.qSum += q;
+	}
+	Drum.FlowSteam = Drum.qSum / Drum.enthEvap;
+	for (auto& iBranch : Branches) {
+		iBranch.qSum = 0.;
+		for (const auto& iTb : iBranch.NbTbInBr) {
+			iBranch.qSum += Tubes[iTb].q;
+		}
+		iBranch.isLastCalcValid = false; // the heat is not part of the inputs compared by --skip-tol
+	}
+}
+
+/**
+ * calculation of one load case in its own model
+ * \param Case load case, results are set
+ * \param Start model to start from: the meshed model (with flow of initFlow()) or the converged model of a neighbouring case
+ * \param StartName name of the neighbouring case, empty: Start is the meshed model, its flow is scaled by the steam flow
+ * \param BaseOptions options and switches of the meshed model
+ * \param qBase heat of each tube as read from .dat file [kW]
+ * \param PathBase path and project name
+ * \return converged model, nullptr if not converged
+ */
+static unique_ptr<_circulationModel> calculateCase(SweepCase& Case, const _circulationModel& Start, const string& StartName,
+	const _base& BaseOptions, const vector<double>& qBase, const string& PathBase) {
+	auto Model = make_unique<_circulationModel>(Start);
+	_activeModel Active(*Model);
+	auto TimeStart = chrono::steady_clock::now();
+	Base = BaseOptions;
+	PathFile = PathBase + "_" + Case.Name;
+	prot.exceptions(ofstream::failbit | ofstream::badbit);
+	try {
+		prot.open((PathFile + ".pro").c_str());
+	}
+	catch (system_error& e) {
+		throw _wscError(PathFile + ".pro : " + e.code().message());
+	}
+	double FlowSteamStart = Drum.FlowSteam;
+	applyCase(Case, qBase);
+	prot << "\n load case " << Case.Name << " drum pressure " << Drum.pMPa << " MPa, heat " << Drum.qSum << " kW";
+	if (StartName.empty()) {
+		/// a case without converged neighbour starts from the flow of initFlow(), scaled by the steam flow, and the static node pressure
+		double Scale = Drum.FlowSteam / FlowSteamStart;
+		for (auto& iBranch : Branches) {
+			iBranch.g *= Scale;
+			iBranch.gNew *= Scale;
+		}
+		for (auto& iNode : Nodes) {
+			iNode.pNode = 0.9 * Drum.rhoW * 9.80665 * (100. - iNode.Elev); //drum elevation is 100m
+		}
+		prot << ", start from initial flow" << endl;
+	}
+	else {
+		prot << ", start from converged load case " << StartName << endl;
+	}
+	try {
+		Case.isConverged = FlowIteration(false);
+		Case.NoIterations = Base.iterg;
+		Case.qSum = Drum.qSum;
+		Case.FlowSteam = Drum.FlowSteam;
+		Case.FlowCirc = 0.;
+		for (const auto& Leave : Nodes[DRUM].NbBrLeave) {
+			Case.FlowCirc += Branches[Leave].g;
+		}
+		Case.SafetyMin = 1e30;
+		for (auto& iTube : Tubes) {
+			iTube.Criteria(*Model);
+			const _tubeOutput& iTubeOut = TubesOutput[iTube.Number];
+			if (iTube.q > 0. && iTubeOut.SafetyFactor > 0.) {
+				Case.SafetyMin = fmin(Case.SafetyMin, iTubeOut.SafetyFactor);
+			}
+		}
+		prot << "\n load case " << Case.Name << (Case.isConverged ? " converged" : " not converged")
+			<< " after " << Case.NoIterations << " iterations" << endl;
+	}
+	catch (const _wscError& Error) {
+		prot.setBuffer(nullptr);
+		prot << "\n calculation stopped: " << Error.what() << endl;
+		Case.isConverged = false;
+		Case.Error = Error.what();
+	}
+	for (const auto& iFileName : FileNames) {
+		remove(iFileName.c_str());
+	}
+	FileNames.clear();
+	prot.close();
+	Case.Seconds = chrono::duration<double>(chrono::steady_clock::now() - TimeStart).count();
+	if (!Case.isConverged) Model.reset();
+	return Model;
+}
+
+int Sweep() {
+	_circulationModel& Meshed = *ActiveModel;
+	vector<SweepCase> Cases = readCaseTable(Base.SweepFile);
+	setParameters(Cases);
+	vector<double> qBase(mTb + 1);
+	for (const auto& iTube : Tubes) {
+		qBase[iTube.Number] = iTube.q;
+	}
+	const _base BaseOptions = Base;
+	const string PathBase = PathFile;
+
+	size_t NoThreads = Base.SweepThreads > 0 ? static_cast<size_t>(Base.SweepThreads) : max<size_t>(1, thread::hardware_concurrency());
+	NoThreads = min(NoThreads, Cases.size());
+	/**
+	 * cases that start from the flow of initFlow() (seeds): about one of 8 cases, spread over the table\n
+	 * the first is the case closest to all others, then always the case farthest from the seeds chosen
+	 */
+	size_t NoSeeds = min(NoThreads, (Cases.size() + 7) / 8);
+	vector<size_t> Seeds;
+	vector<double> DistSeed(Cases.size(), 1e30);
+	for (size_t iSeed = 0; iSeed < NoSeeds; ++iSeed) {
+		size_t Best = 0;
+		double BestValue = 1e30;
+		for (size_t iCase = 0; iCase < Cases.size(); ++iCase) {
+			double Value = 0.;
+			if (Seeds.empty()) {
+				for (const auto& Other : Cases) Value += Distance(Cases[iCase], Other);
+			}
+			else {
+				Value = -DistSeed[iCase];
+			}
+			if (Value < BestValue) {
+				BestValue = Value;
+				Best = iCase;
+			}
+		}
+		Seeds.push_back(Best);
+		for (size_t iCase = 0; iCase < Cases.size(); ++iCase) {
+			DistSeed[iCase] = fmin(DistSeed[iCase], Distance(Cases[iCase], Cases[Best]));
+		}
+	}
+	prot << "\n load case sweep: " << Cases.size() << " cases from " << Base.SweepFile << ", " << NoThreads << " cases in parallel" << endl;
+	cout << "\n load case sweep: " << Cases.size() << " cases, " << NoThreads << " in parallel" << endl;
+
+	mutex Lock;
+	condition_variable CaseDone;
+	size_t NoColdStarted = 0;
+	size_t NoRunning = 0;
+	auto TimeStart = chrono::steady_clock::now();
+	/**
+	 * each thread takes the next case: the pending case nearest to a converged case starts from that case,
+	 * if there is no converged case yet, a seed starts from the flow of initFlow() (or any case if nothing is running)
+	 */
+	auto Worker = [&]() {
+#ifdef _OPENMP
+		omp_set_num_threads(max(1, omp_get_max_threads() / static_cast<int>(NoThreads)));
+#endif
+		unique_lock<mutex> Guard(Lock);
+		while (true) {
+			size_t Next = MINUS1, Source = MINUS1;
+			double DistMin = 1e30;
+			bool isPending = false;
+			for (size_t iCase = 0; iCase < Cases.size(); ++iCase) {
+				if (Cases[iCase].State != CaseState::Pending) continue;
+				isPending = true;
+				for (size_t jCase = 0; jCase < Cases.size(); ++jCase) {
+					if (Cases[jCase].Converged && Distance(Cases[iCase], Cases[jCase]) < DistMin) {
+						DistMin = Distance(Cases[iCase], Cases[jCase]);
+						Next = iCase;
+						Source = jCase;
+					}
+				}
+			}
+			if (!isPending) break;
+			if (Next == MINUS1) {
+				for (size_t iCase = 0; iCase < Cases.size(); ++iCase) {
+					bool isSeed = find(Seeds.begin(), Seeds.end(), iCase) != Seeds.end();
+					if (Cases[iCase].State == CaseState::Pending && ((isSeed && NoColdStarted < NoSeeds) || NoRunning == 0)) {
+						Next = iCase;
+						break;
+					}
+				}
+			}
+			if (Next == MINUS1) {
+				CaseDone.wait(Guard);
+				continue;
+			}
+			SweepCase& Case = Cases[Next];
+			Case.State = CaseState::Running;
+			Case.Source = Source;
+			if (Source == MINUS1) ++NoColdStarted;
+			++NoRunning;
+			Guard.unlock();
+			const _circulationModel& Start = Source == MINUS1 ? Meshed : *Cases[Source].Converged;
+			unique_ptr<_circulationModel> Converged;
+			try {
+				Converged = calculateCase(Case, Start, Source == MINUS1 ? string() : Cases[Source].Name, BaseOptions, qBase, PathBase);
+			}
+			catch (const exception& Error) {
+				Case.Error = Error.what();
+			}
+			Guard.lock();
+			Case.Converged = std::move(Converged);
+			Case.State = CaseState::Done;
+			--NoRunning;
+			cout << "\n load case " << Case.Name << ": " << Case.NoIterations << " iterations, start from "
+				<< (Source == MINUS1 ? string("initial flow") : Cases[Source].Name)
+				<< (Case.isConverged ? "" : (Case.Error.empty() ? ", not converged" : ", stopped: " + Case.Error)) << endl;
+			CaseDone.notify_all();
+		}
+	};
+	vector<thread> Threads;
+	for (size_t iThread = 0; iThread < NoThreads; ++iThread) {
+		Threads.emplace_back(Worker);
+	}
+	for (auto& iThread : Threads) {
+		iThread.join();
+	}
+	double Seconds = chrono::duration<double>(chrono::steady_clock::now() - TimeStart).count();
+
+	/// one table with the results of all cases (*projectname*_sweep.txt)
+	string rname = PathBase + "_sweep.txt";
+	ofstream result(rname.c_str());
+	if (!result.good()) {
+		cout << "\n cannot open file " << rname << endl;
+		throw _wscError("cannot open file " + rname);
+	}
+	result << "case\tpMPa\tLevelW\tdpDyn\tLoad\theat\tsteam\tcirculation\tCR\tsafety\titerations\tstart\ttime\tresult\n";
+	result << "\t[MPa]\t[m]\t[kPa]\t[-]\t[kW]\t[kg/s]\t[kg/s]\t[-]\tfactor\t\t\t[s]\n";
+	result.setf(ios::fixed, ios::floatfield);
+	int NoConverged = 0;
+	int NoIterations = 0;
+	for (const auto& Case : Cases) {
+		NoConverged += Case.isConverged ? 1 : 0;
+		NoIterations += Case.NoIterations;
+		result << Case.Name << "\t" << setprecision(3) << Case.pMPa << "\t" << Case.LevelW << "\t" << Case.dpDyn << "\t" << Case.Load << "\t"
+			<< setprecision(1) << Case.qSum << "\t" << setprecision(3) << Case.FlowSteam << "\t" << Case.FlowCirc << "\t"
+			<< setprecision(2) << (Case.FlowSteam > 0. ? Case.FlowCirc / Case.FlowSteam : 0.) << "\t";
+		if (Case.SafetyMin < 1e29) {
+			result << Case.SafetyMin << "\t";
+		}
+		else {
+			result << "-\t";
+		}
+		result << Case.NoIterations << "\t" << (Case.Source == MINUS1 ? string("initFlow") : Cases[Case.Source].Name) << "\t"
+			<< Case.Seconds << "\t" << (Case.isConverged ? "converged" : (Case.Error.empty() ? "not converged" : Case.Error)) << "\n";
+	}
+	result.close();
+	prot << "\n load case sweep: " << NoConverged << " of " << Cases.size() << " cases converged, " << NoIterations
+		<< " iterations in total, " << Seconds << " s, results in " << rname << endl;
+	cout << "\n " << NoConverged << " of " << Cases.size() << " load cases converged, " << NoIterations
+		<< " iterations, " << Seconds << " s, results in " << rname << endl;
+	prot.close();
+	return NoConverged == static_cast<int>(Cases.size()) ? 0 : 2;
+}